@@ -158,6 +158,26 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Returns a stamp that changes whenever the object referred by this path
+	 * is modified. For a directory, this includes adding, removing or renaming
+	 * its entries.
+	 *
+	 * @note By default, this method returns 0, meaning that the stamp is unknown.
+	 *
+	 * @return the modification stamp, or 0 if it is unknown or not yet reliable.
+	 */
+	virtual uint32 getModificationTime() const { return 0; }
+
+	/**
+	 * Returns the size of the file referred by this path, without opening it.
+	 *
+	 * @note By default, this method returns -1, meaning that the size is unknown.
+	 *
+	 * @return the size in bytes, or -1 if it is unknown or this is not a file.
+	 */
+	virtual int32 getFileSize() const { return -1; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
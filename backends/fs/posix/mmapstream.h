@@ -0,0 +1,54 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_FS_POSIX_MMAPSTREAM_H
+#define BACKENDS_FS_POSIX_MMAPSTREAM_H
+
+#include "common/memstream.h"
+#include "common/str.h"
+
+/**
+ * Read stream for a file mapped into memory. Reads and seeks are served
+ * from the mapping without any system calls, and peekPointer() gives
+ * direct access to the file contents.
+ *
+ * The file must not be truncated while the stream exists.
+ */
+class MmapStream : public Common::MemoryReadStream {
+public:
+	/**
+	 * Maps the file at the given path into memory.
+	 *
+	 * @return the stream, or 0 if the file could not be mapped
+	 */
+	static MmapStream *makeFromPath(const Common::String &path);
+
+	~MmapStream();
+
+private:
+	MmapStream(void *mapping, uint32 size);
+
+	void *_mapping;
+	uint32 _mappingSize;
+};
+
+#endif
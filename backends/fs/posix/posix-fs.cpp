@@ -24,17 +24,21 @@
 // Re-enable some forbidden symbols to avoid clashes with stat.h and unistd.h.
 // Also with clock() in sys/time.h in some Mac OS X SDKs.
 #define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_time
 #define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
 #define FORBIDDEN_SYMBOL_EXCEPTION_mkdir
 #define FORBIDDEN_SYMBOL_EXCEPTION_getenv
 #define FORBIDDEN_SYMBOL_EXCEPTION_exit		//Needed for IRIX's unistd.h
 
 #include "backends/fs/posix/posix-fs.h"
+#include "backends/fs/posix/mmapstream.h"
 #include "backends/fs/stdiostream.h"
 #include "common/algorithm.h"
+#include "common/config-manager.h"
 
 #include <sys/param.h>
 #include <sys/stat.h>
+#include <time.h>
 #include <dirent.h>
 #include <stdio.h>
 
@@ -97,6 +101,28 @@ POSIXFilesystemNode::POSIXFilesystemNode(const Common::String &p) {
 	setFlags();
 }
 
+uint32 POSIXFilesystemNode::getModificationTime() const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0)
+		return 0;
+
+	// Timestamps only have a resolution of one second, so a change made
+	// within the same second would go unnoticed. Don't vouch for anything
+	// that was modified that recently.
+	if (st.st_mtime + 1 >= time(0))
+		return 0;
+
+	return (uint32)st.st_mtime;
+}
+
+int32 POSIXFilesystemNode::getFileSize() const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode) || st.st_size > 0x7FFFFFFF)
+		return -1;
+
+	return (int32)st.st_size;
+}
+
 AbstractFSNode *POSIXFilesystemNode::getChild(const Common::String &n) const {
 	assert(!_path.empty());
 	assert(_isDirectory);
@@ -243,6 +269,25 @@ AbstractFSNode *POSIXFilesystemNode::getParent() const {
 }
 
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
+#if defined(POSIX)
+	// Map big files into memory, so that the many small seeks and reads
+	// engines do in resource bundles do not each need system calls. This
+	// can be disabled with the "mmap_files" setting.
+	enum {
+		kMinMappedFileSize = 1024 * 1024,
+		kMaxMappedFileSize32 = 64 * 1024 * 1024	///< Limit for 32 bit address spaces
+	};
+
+	struct stat st;
+	if (stat(_path.c_str(), &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= kMinMappedFileSize
+			&& (sizeof(void *) >= 8 || st.st_size <= kMaxMappedFileSize32)
+			&& (!ConfMan.hasKey("mmap_files") || ConfMan.getBool("mmap_files"))) {
+		Common::SeekableReadStream *stream = MmapStream::makeFromPath(getPath());
+		if (stream)
+			return stream;
+	}
+#endif
+
 	return StdioStream::makeFromPath(getPath(), false);
 }
 
@@ -30,6 +30,7 @@
 #include "common/util.h"
 #include "common/fs.h"
 #include "common/archive.h"
+#include "common/bufferedstream.h"
 #include "common/config-manager.h"
 #include "common/zlib.h"
 
@@ -111,8 +112,13 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 
 	// Open the file for saving
 	Common::WriteStream *sf = file.createWriteStream();
+	if (compress)
+		sf = Common::wrapCompressedWriteStream(sf);
 
-	return compress ? Common::wrapCompressedWriteStream(sf) : sf;
+	// Engines tend to write their savegames a few bytes at a time, which
+	// is slow when every write goes through the compressor and the file.
+	// Collect the data first and pass it on in large pieces.
+	return Common::wrapBufferedWriteStream(sf, kSaveBufferSize);
 }
 
 bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
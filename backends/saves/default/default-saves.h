@@ -42,6 +42,11 @@ public:
 	virtual bool removeSavefile(const Common::String &filename);
 
 protected:
+	enum {
+		/** Size of the buffer in front of savefiles opened for saving. */
+		kSaveBufferSize = 128 * 1024
+	};
+
 	/**
 	 * Get the path to the savegame directory.
 	 * Should only be used internally since some platforms
@@ -540,6 +540,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Common::DebugManager::destroy();
 	Common::EventRecorder::destroy();
 	Common::SearchManager::destroy();
+	Common::FSDirectory::clearListingCache();
 #ifdef USE_TRANSLATION
 	Common::TranslationManager::destroy();
 #endif
@@ -444,6 +444,7 @@ void PluginManager::addToPluginsInMemList(Plugin *plugin) {
 
 // Engine plugins
 
+#include "engines/advancedDetector.h"
 #include "engines/metaengine.h"
 
 namespace Common {
@@ -527,6 +528,7 @@ GameList EngineManager::detectGames(const Common::FSList &fslist) const {
 			candidates.push_back((**iter)->detectGames(fslist));
 		}
 	} while (PluginManager::instance().loadNextPlugin());
+	AdvancedMetaEngine::saveFilePropertiesCache();
 	return candidates;
 }
 
@@ -50,12 +50,34 @@ ReadStream *wrapBufferedReadStream(ReadStream *parentStream, uint32 bufSize, Dis
  */
 SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream);
 
+/**
+ * Take an arbitrary SeekableReadStream and wrap it in a custom stream which
+ * transparently provides buffering adapted to how the stream is used.
+ *
+ * The data is kept in a few separate blocks, so that going back and forth
+ * between some positions, for example between the audio and video data of
+ * a movie, does not throw away buffered data. Each time the stream is read
+ * on right after the data buffered last, the next block is made twice as
+ * big, up to 256KB; any other access starts over with 4KB blocks.
+ *
+ * Streams which already hold their data in memory are returned unwrapped
+ * if they are to be disposed with the wrapper.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ */
+SeekableReadStream *wrapAdaptiveBufferedSeekableReadStream(SeekableReadStream *parentStream, DisposeAfterUse::Flag disposeParentStream);
+
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream which
  * transparently provides buffering.
  * Users can specify how big the buffer should be. Currently, the
  * parent stream is \em always disposed when the wrapper is disposed.
  *
+ * finalize() writes out the buffer and finalizes the parent stream, and
+ * err() reports failures of both, so that callers can check whether all
+ * data arrived.
+ *
  * It is safe to call this with a NULL parameter (in this case, NULL is
  * returned).
  */
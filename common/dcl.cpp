@@ -25,9 +25,21 @@
 #include "common/memstream.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
+#include "common/util.h"
 
 namespace Common {
 
+/**
+ * Lookup table entry for decoding the first HUFFMAN_TABLE_BITS bits of a
+ * code at once. Codes which are longer than that continue at tree node
+ * 'value' instead of yielding a leaf value.
+ */
+struct DCLHuffmanEntry {
+	uint16 value;
+	byte length;
+	bool leaf;
+};
+
 class DecompressorDCL {
 public:
 	bool unpack(ReadStream *src, byte *dest, uint32 nPacked, uint32 nUnpacked);
@@ -59,13 +71,19 @@ protected:
 
 	void fetchBitsLSB();
 
+	/**
+	 * Get the next byte of compressed data. The first _szPacked bytes are
+	 * read from _src in blocks, anything beyond that byte by byte.
+	 */
+	byte readByte();
+
 	/**
 	 * Write one byte into _dest stream
 	 * @param b byte to put
 	 */
 	void putByte(byte b);
 
-	int huffman_lookup(const int *tree);
+	int huffman_lookup(const int *tree, const DCLHuffmanEntry *table);
 
 	uint32 _dwBits;		///< bits buffer
 	byte _nBits;		///< number of unread bits in _dwBits
@@ -75,6 +93,12 @@ protected:
 	uint32 _dwWrote;	///< number of bytes written to _dest
 	ReadStream *_src;
 	byte *_dest;
+
+	enum { kInputBufferSize = 1024 };
+	byte _inBuffer[kInputBufferSize];
+	uint32 _inPos;		///< read position in _inBuffer
+	uint32 _inSize;		///< number of valid bytes in _inBuffer
+	uint32 _inRead;		///< number of bytes read from _src into _inBuffer
 };
 
 void DecompressorDCL::init(ReadStream *src, byte *dest, uint32 nPacked, uint32 nUnpacked) {
@@ -85,11 +109,29 @@ void DecompressorDCL::init(ReadStream *src, byte *dest, uint32 nPacked, uint32 n
 	_nBits = 0;
 	_dwRead = _dwWrote = 0;
 	_dwBits = 0;
+	_inPos = _inSize = _inRead = 0;
+}
+
+byte DecompressorDCL::readByte() {
+	if (_inPos == _inSize) {
+		if (_inRead >= _szPacked)
+			return _src->readByte();
+
+		_inSize = _src->read(_inBuffer, MIN<uint32>(kInputBufferSize, _szPacked - _inRead));
+		_inPos = 0;
+		_inRead += _inSize;
+		if (!_inSize) {
+			// Nothing left, make sure we do not try again
+			_inRead = _szPacked;
+			return 0;
+		}
+	}
+	return _inBuffer[_inPos++];
 }
 
 void DecompressorDCL::fetchBitsLSB() {
 	while (_nBits <= 24) {
-		_dwBits |= ((uint32)_src->readByte()) << _nBits;
+		_dwBits |= ((uint32)readByte()) << _nBits;
 		_nBits += 8;
 		_dwRead++;
 	}
@@ -316,16 +358,61 @@ static const int ascii_tree[] = {
 	LN(509, 128)      LN(510, 26)
 };
 
-int DecompressorDCL::huffman_lookup(const int *tree) {
+#define HUFFMAN_TABLE_BITS 8
+
+static DCLHuffmanEntry length_table[1 << HUFFMAN_TABLE_BITS];
+static DCLHuffmanEntry distance_table[1 << HUFFMAN_TABLE_BITS];
+static DCLHuffmanEntry ascii_table[1 << HUFFMAN_TABLE_BITS];
+
+static void buildHuffmanTable(const int *tree, int pos, uint32 code, int depth, DCLHuffmanEntry *table) {
+	if ((tree[pos] & HUFFMAN_LEAF) || depth == HUFFMAN_TABLE_BITS) {
+		// Bits are read starting with the least significant one, so every
+		// index sharing the low 'depth' bits decodes to this entry
+		for (uint32 i = code; i < (1 << HUFFMAN_TABLE_BITS); i += 1 << depth) {
+			table[i].leaf = (tree[pos] & HUFFMAN_LEAF) != 0;
+			table[i].value = table[i].leaf ? tree[pos] & 0xFFFF : pos;
+			table[i].length = depth;
+		}
+		return;
+	}
+
+	buildHuffmanTable(tree, tree[pos] >> 12, code, depth + 1, table);
+	buildHuffmanTable(tree, tree[pos] & 0xFFF, code | (1 << depth), depth + 1, table);
+}
+
+static void initHuffmanTables() {
+	static bool initialized = false;
+	if (initialized)
+		return;
+
+	buildHuffmanTable(length_tree, 0, 0, 0, length_table);
+	buildHuffmanTable(distance_tree, 0, 0, 0, distance_table);
+	buildHuffmanTable(ascii_tree, 0, 0, 0, ascii_table);
+	initialized = true;
+}
+
+int DecompressorDCL::huffman_lookup(const int *tree, const DCLHuffmanEntry *table) {
 	int pos = 0;
 
+	// Decode the first bits of the code with a single table lookup. Near the
+	// end of the data there may not be enough bits left for that, then the
+	// tree is walked bit by bit as usual.
+	if (_nBits < HUFFMAN_TABLE_BITS && (_inPos < _inSize || _inRead < _szPacked))
+		fetchBitsLSB();
+	if (_nBits >= HUFFMAN_TABLE_BITS) {
+		const DCLHuffmanEntry &entry = table[_dwBits & ((1 << HUFFMAN_TABLE_BITS) - 1)];
+		_dwBits >>= entry.length;
+		_nBits -= entry.length;
+		if (entry.leaf)
+			return entry.value;
+		pos = entry.value;
+	}
+
 	while (!(tree[pos] & HUFFMAN_LEAF)) {
 		int bit = getBitsLSB(1);
-		debug(8, "[%d]:%d->", pos, bit);
 		pos = bit ? tree[pos] & 0xFFF : tree[pos] >> 12;
 	}
 
-	debug(8, "=%02x\n", tree[pos] & 0xffff);
 	return tree[pos] & 0xFFFF;
 }
 
@@ -334,6 +421,7 @@ int DecompressorDCL::huffman_lookup(const int *tree) {
 
 bool DecompressorDCL::unpack(ReadStream *src, byte *dest, uint32 nPacked, uint32 nUnpacked) {
 	init(src, dest, nPacked, nUnpacked);
+	initHuffmanTables();
 
 	int value;
 	uint32 val_distance, val_length;
@@ -351,7 +439,7 @@ bool DecompressorDCL::unpack(ReadStream *src, byte *dest, uint32 nPacked, uint32
 
 	while (_dwWrote < _szUnpacked) {
 		if (getBitsLSB(1)) { // (length,distance) pair
-			value = huffman_lookup(length_tree);
+			value = huffman_lookup(length_tree, length_table);
 
 			if (value < 8)
 				val_length = value + 2;
@@ -360,7 +448,7 @@ bool DecompressorDCL::unpack(ReadStream *src, byte *dest, uint32 nPacked, uint32
 
 			debug(8, " | ");
 
-			value = huffman_lookup(distance_tree);
+			value = huffman_lookup(distance_tree, distance_table);
 
 			if (val_length == 2)
 				val_distance = (value << 2) | getBitsLSB(2);
@@ -384,19 +472,22 @@ bool DecompressorDCL::unpack(ReadStream *src, byte *dest, uint32 nPacked, uint32
 				uint32 copy_length = (val_length > val_distance) ? val_distance : val_length;
 				assert(val_distance >= copy_length);
 				uint32 pos = _dwWrote - val_distance;
-				for (uint32 i = 0; i < copy_length; i++)
-					putByte(dest[pos + i]);
+				// The ranges never overlap, as copy_length <= val_distance
+				memcpy(dest + _dwWrote, dest + pos, copy_length);
+				_dwWrote += copy_length;
 
-				for (uint32 i = 0; i < copy_length; i++)
-					debug(9, "\33[32;31m%02x\33[37;37m ", dest[pos + i]);
-				debug(9, "\n");
+				if (gDebugLevel >= 9) {
+					for (uint32 i = 0; i < copy_length; i++)
+						debug(9, "\33[32;31m%02x\33[37;37m ", dest[pos + i]);
+					debug(9, "\n");
+				}
 
 				val_length -= copy_length;
 				val_distance += copy_length;
 			}
 
 		} else { // Copy byte verbatim
-			value = (mode == DCL_ASCII_MODE) ? huffman_lookup(ascii_tree) : getByteLSB();
+			value = (mode == DCL_ASCII_MODE) ? huffman_lookup(ascii_tree, ascii_table) : getByteLSB();
 			putByte(value);
 			debug(9, "\33[32;31m%02x \33[37;37m", value);
 		}
@@ -19,6 +19,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "common/mutex.h"
+#include "common/singleton.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 #include "backends/fs/abstract-fs.h"
@@ -124,6 +126,14 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+uint32 FSNode::getModificationTime() const {
+	return _realNode ? _realNode->getModificationTime() : 0;
+}
+
+int32 FSNode::getFileSize() const {
+	return _realNode ? _realNode->getFileSize() : -1;
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == 0)
 		return 0;
@@ -151,6 +161,64 @@ WriteStream *FSNode::createWriteStream() const {
 	return _realNode->createWriteStream();
 }
 
+/**
+ * Listings of directories scanned by FSDirectory, keyed by their path. A
+ * listing is reused as long as the directory reports the same modification
+ * stamp as when it was listed, which saves listing it (and on some systems,
+ * checking every single entry) again.
+ */
+class FSListingCache : public Singleton<FSListingCache> {
+public:
+	void getChildren(const FSNode &node, FSList &list);
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	FSListingCache() {}
+
+	enum {
+		kMaxEntries = 4096
+	};
+
+	struct Listing {
+		uint32 stamp;
+		FSList children;
+	};
+
+	typedef HashMap<String, Listing> ListingMap;
+	ListingMap _listings;
+	Mutex _mutex;
+};
+
+DECLARE_SINGLETON(FSListingCache);
+
+void FSListingCache::getChildren(const FSNode &node, FSList &list) {
+	// Query the stamp before listing, so that a change made while listing
+	// invalidates the listing next time.
+	const uint32 stamp = node.getModificationTime();
+	const String path = stamp ? node.getPath() : String();
+
+	if (stamp) {
+		StackLock lock(_mutex);
+		ListingMap::const_iterator it = _listings.find(path);
+		if (it != _listings.end() && it->_value.stamp == stamp) {
+			list = it->_value.children;
+			return;
+		}
+	}
+
+	node.getChildren(list, FSNode::kListAll, true);
+	if (!stamp)
+		return;
+
+	StackLock lock(_mutex);
+	if (_listings.size() >= kMaxEntries && !_listings.contains(path))
+		_listings.clear();
+
+	Listing &listing = _listings[path];
+	listing.stamp = stamp;
+	listing.children = list;
+}
+
 FSDirectory::FSDirectory(const FSNode &node, int depth, bool flat)
   : _node(node), _cached(false), _depth(depth), _flat(flat) {
 }
@@ -174,6 +242,10 @@ FSDirectory::FSDirectory(const String &prefix, const String &name, int depth, bo
 FSDirectory::~FSDirectory() {
 }
 
+void FSDirectory::clearListingCache() {
+	FSListingCache::destroy();
+}
+
 void FSDirectory::setPrefix(const String &prefix) {
 	_prefix = prefix;
 
@@ -256,7 +328,7 @@ void FSDirectory::cacheDirectoryRecursive(FSNode node, int depth, const String&
 		return;
 
 	FSList list;
-	node.getChildren(list, FSNode::kListAll, true);
+	FSListingCache::instance().getChildren(node, list);
 
 	FSList::iterator it = list.begin();
 	for ( ; it != list.end(); ++it) {
@@ -205,6 +205,23 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Returns a stamp that changes whenever the object referred by this node
+	 * is modified. For a directory, this includes adding, removing or renaming
+	 * its entries, which makes it suitable for validating cached listings.
+	 *
+	 * @return the modification stamp, or 0 if it is unknown or not yet reliable.
+	 */
+	uint32 getModificationTime() const;
+
+	/**
+	 * Returns the size of the file referred by this node, without opening it.
+	 * Not all backends support this.
+	 *
+	 * @return the size in bytes, or -1 if it is unknown or this is not a file.
+	 */
+	int32 getFileSize() const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -301,6 +318,16 @@ public:
 
 	virtual ~FSDirectory();
 
+	/**
+	 * Directory listings are shared between all FSDirectory instances, so that
+	 * a tree scanned again (e.g. when an engine is restarted) only costs one
+	 * modification time check per directory. Listings are only reused while
+	 * FSNode::getModificationTime() reports the directory as unchanged.
+	 *
+	 * This drops all shared listings.
+	 */
+	static void clearListingCache();
+
 	/**
 	 * This return the underlying FSNode of the FSDirectory.
 	 */
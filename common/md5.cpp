@@ -29,187 +29,243 @@
 #include "common/endian.h"
 #include "common/str.h"
 #include "common/stream.h"
+#include "common/util.h"
 
 namespace Common {
 
-struct md5_context {
-	uint32 total[2];
-	uint32 state[4];
-	uint8 buffer[64];
-};
+#define GET_UINT32(n, b, i)	(n) = READ_LE_UINT32(b + i)
+#define PUT_UINT32(n, b, i)	WRITE_LE_UINT32(b + i, n)
 
-static void md5_starts(md5_context *ctx);
-static void md5_update(md5_context *ctx, const uint8 *input, uint32 length);
-static void md5_finish(md5_context *ctx, uint8 digest[16]);
+#define S(x, n) ((x << n) | ((x & 0xFFFFFFFF) >> (32 - n)))
 
+#define F1(x, y, z) (z ^ (x & (y ^ z)))
+#define F2(x, y, z) (y ^ (z & (x ^ y)))
+#define F3(x, y, z) (x ^ y ^ z)
+#define F4(x, y, z) (y ^ (x | ~z))
+
+// The 64 steps of a block, in terms of a step macro P which is defined
+// differently for hashing one and two blocks at once.
+#define MD5_STEPS \
+	P(F1, A, B, C, D,  0,  7, 0xD76AA478) \
+	P(F1, D, A, B, C,  1, 12, 0xE8C7B756) \
+	P(F1, C, D, A, B,  2, 17, 0x242070DB) \
+	P(F1, B, C, D, A,  3, 22, 0xC1BDCEEE) \
+	P(F1, A, B, C, D,  4,  7, 0xF57C0FAF) \
+	P(F1, D, A, B, C,  5, 12, 0x4787C62A) \
+	P(F1, C, D, A, B,  6, 17, 0xA8304613) \
+	P(F1, B, C, D, A,  7, 22, 0xFD469501) \
+	P(F1, A, B, C, D,  8,  7, 0x698098D8) \
+	P(F1, D, A, B, C,  9, 12, 0x8B44F7AF) \
+	P(F1, C, D, A, B, 10, 17, 0xFFFF5BB1) \
+	P(F1, B, C, D, A, 11, 22, 0x895CD7BE) \
+	P(F1, A, B, C, D, 12,  7, 0x6B901122) \
+	P(F1, D, A, B, C, 13, 12, 0xFD987193) \
+	P(F1, C, D, A, B, 14, 17, 0xA679438E) \
+	P(F1, B, C, D, A, 15, 22, 0x49B40821) \
+	\
+	P(F2, A, B, C, D,  1,  5, 0xF61E2562) \
+	P(F2, D, A, B, C,  6,  9, 0xC040B340) \
+	P(F2, C, D, A, B, 11, 14, 0x265E5A51) \
+	P(F2, B, C, D, A,  0, 20, 0xE9B6C7AA) \
+	P(F2, A, B, C, D,  5,  5, 0xD62F105D) \
+	P(F2, D, A, B, C, 10,  9, 0x02441453) \
+	P(F2, C, D, A, B, 15, 14, 0xD8A1E681) \
+	P(F2, B, C, D, A,  4, 20, 0xE7D3FBC8) \
+	P(F2, A, B, C, D,  9,  5, 0x21E1CDE6) \
+	P(F2, D, A, B, C, 14,  9, 0xC33707D6) \
+	P(F2, C, D, A, B,  3, 14, 0xF4D50D87) \
+	P(F2, B, C, D, A,  8, 20, 0x455A14ED) \
+	P(F2, A, B, C, D, 13,  5, 0xA9E3E905) \
+	P(F2, D, A, B, C,  2,  9, 0xFCEFA3F8) \
+	P(F2, C, D, A, B,  7, 14, 0x676F02D9) \
+	P(F2, B, C, D, A, 12, 20, 0x8D2A4C8A) \
+	\
+	P(F3, A, B, C, D,  5,  4, 0xFFFA3942) \
+	P(F3, D, A, B, C,  8, 11, 0x8771F681) \
+	P(F3, C, D, A, B, 11, 16, 0x6D9D6122) \
+	P(F3, B, C, D, A, 14, 23, 0xFDE5380C) \
+	P(F3, A, B, C, D,  1,  4, 0xA4BEEA44) \
+	P(F3, D, A, B, C,  4, 11, 0x4BDECFA9) \
+	P(F3, C, D, A, B,  7, 16, 0xF6BB4B60) \
+	P(F3, B, C, D, A, 10, 23, 0xBEBFBC70) \
+	P(F3, A, B, C, D, 13,  4, 0x289B7EC6) \
+	P(F3, D, A, B, C,  0, 11, 0xEAA127FA) \
+	P(F3, C, D, A, B,  3, 16, 0xD4EF3085) \
+	P(F3, B, C, D, A,  6, 23, 0x04881D05) \
+	P(F3, A, B, C, D,  9,  4, 0xD9D4D039) \
+	P(F3, D, A, B, C, 12, 11, 0xE6DB99E5) \
+	P(F3, C, D, A, B, 15, 16, 0x1FA27CF8) \
+	P(F3, B, C, D, A,  2, 23, 0xC4AC5665) \
+	\
+	P(F4, A, B, C, D,  0,  6, 0xF4292244) \
+	P(F4, D, A, B, C,  7, 10, 0x432AFF97) \
+	P(F4, C, D, A, B, 14, 15, 0xAB9423A7) \
+	P(F4, B, C, D, A,  5, 21, 0xFC93A039) \
+	P(F4, A, B, C, D, 12,  6, 0x655B59C3) \
+	P(F4, D, A, B, C,  3, 10, 0x8F0CCC92) \
+	P(F4, C, D, A, B, 10, 15, 0xFFEFF47D) \
+	P(F4, B, C, D, A,  1, 21, 0x85845DD1) \
+	P(F4, A, B, C, D,  8,  6, 0x6FA87E4F) \
+	P(F4, D, A, B, C, 15, 10, 0xFE2CE6E0) \
+	P(F4, C, D, A, B,  6, 15, 0xA3014314) \
+	P(F4, B, C, D, A, 13, 21, 0x4E0811A1) \
+	P(F4, A, B, C, D,  4,  6, 0xF7537E82) \
+	P(F4, D, A, B, C, 11, 10, 0xBD3AF235) \
+	P(F4, C, D, A, B,  2, 15, 0x2AD7D2BB) \
+	P(F4, B, C, D, A,  9, 21, 0xEB86D391)
+
+static void loadBlock(uint32 X[16], const uint8 *data) {
+	for (int i = 0; i < 16; i++)
+		GET_UINT32(X[i], data, i * 4);
+}
 
-#define GET_UINT32(n, b, i)	(n) = READ_LE_UINT32(b + i)
-#define PUT_UINT32(n, b, i)	WRITE_LE_UINT32(b + i, n)
+/**
+ * Process 'count' consecutive 64 byte blocks. The state is kept in local
+ * variables across blocks.
+ */
+static void processBlocks(uint32 state[4], const uint8 *data, uint32 count) {
+	uint32 X[16];
+	uint32 A = state[0];
+	uint32 B = state[1];
+	uint32 C = state[2];
+	uint32 D = state[3];
+
+#define P(f, a, b, c, d, k, s, t)             \
+{                                             \
+	a += f(b, c, d) + X[k] + t; a = S(a, s) + b; \
+}
+
+	for (; count; count--, data += 64) {
+		const uint32 AA = A, BB = B, CC = C, DD = D;
+
+		loadBlock(X, data);
+		MD5_STEPS
+
+		A += AA;
+		B += BB;
+		C += CC;
+		D += DD;
+	}
+
+#undef P
 
-void md5_starts(md5_context *ctx) {
-	ctx->total[0] = 0;
-	ctx->total[1] = 0;
+	state[0] = A;
+	state[1] = B;
+	state[2] = C;
+	state[3] = D;
+}
 
-	ctx->state[0] = 0x67452301;
-	ctx->state[1] = 0xEFCDAB89;
-	ctx->state[2] = 0x98BADCFE;
-	ctx->state[3] = 0x10325476;
+/**
+ * Process 'count' blocks of two independent computations. The steps of
+ * both are interleaved, so that the CPU can work on one while the other
+ * waits for the result of the previous step.
+ */
+static void processBlockPairs(uint32 state0[4], const uint8 *data0, uint32 state1[4], const uint8 *data1, uint32 count) {
+	uint32 X0[16], X1[16];
+	uint32 A0 = state0[0], A1 = state1[0];
+	uint32 B0 = state0[1], B1 = state1[1];
+	uint32 C0 = state0[2], C1 = state1[2];
+	uint32 D0 = state0[3], D1 = state1[3];
+
+#define P(f, a, b, c, d, k, s, t)                        \
+{                                                        \
+	a##0 += f(b##0, c##0, d##0) + X0[k] + t;             \
+	a##1 += f(b##1, c##1, d##1) + X1[k] + t;             \
+	a##0 = S(a##0, s) + b##0;                            \
+	a##1 = S(a##1, s) + b##1;                            \
 }
 
-static void md5_process(md5_context *ctx, const uint8 data[64]) {
-	uint32 X[16], A, B, C, D;
-
-	GET_UINT32(X[0],  data,  0);
-	GET_UINT32(X[1],  data,  4);
-	GET_UINT32(X[2],  data,  8);
-	GET_UINT32(X[3],  data, 12);
-	GET_UINT32(X[4],  data, 16);
-	GET_UINT32(X[5],  data, 20);
-	GET_UINT32(X[6],  data, 24);
-	GET_UINT32(X[7],  data, 28);
-	GET_UINT32(X[8],  data, 32);
-	GET_UINT32(X[9],  data, 36);
-	GET_UINT32(X[10], data, 40);
-	GET_UINT32(X[11], data, 44);
-	GET_UINT32(X[12], data, 48);
-	GET_UINT32(X[13], data, 52);
-	GET_UINT32(X[14], data, 56);
-	GET_UINT32(X[15], data, 60);
+	for (; count; count--, data0 += 64, data1 += 64) {
+		const uint32 AA0 = A0, BB0 = B0, CC0 = C0, DD0 = D0;
+		const uint32 AA1 = A1, BB1 = B1, CC1 = C1, DD1 = D1;
 
-#define S(x, n) ((x << n) | ((x & 0xFFFFFFFF) >> (32 - n)))
+		loadBlock(X0, data0);
+		loadBlock(X1, data1);
+		MD5_STEPS
+
+		A0 += AA0; A1 += AA1;
+		B0 += BB0; B1 += BB1;
+		C0 += CC0; C1 += CC1;
+		D0 += DD0; D1 += DD1;
+	}
+
+#undef P
+
+	state0[0] = A0; state1[0] = A1;
+	state0[1] = B0; state1[1] = B1;
+	state0[2] = C0; state1[2] = C1;
+	state0[3] = D0; state1[3] = D1;
+}
 
-#define P(a, b, c, d, k, s, t)                    \
-{                                                 \
-	a += F(b,c,d) + X[k] + t; a = S(a,s) + b; \
+#undef MD5_STEPS
+#undef F1
+#undef F2
+#undef F3
+#undef F4
+#undef S
+
+void MD5::reset() {
+	_total[0] = 0;
+	_total[1] = 0;
+
+	_state[0] = 0x67452301;
+	_state[1] = 0xEFCDAB89;
+	_state[2] = 0x98BADCFE;
+	_state[3] = 0x10325476;
 }
 
-	A = ctx->state[0];
-	B = ctx->state[1];
-	C = ctx->state[2];
-	D = ctx->state[3];
-
-#define F(x, y, z) (z ^ (x & (y ^ z)))
-
-	P(A, B, C, D,  0,  7, 0xD76AA478);
-	P(D, A, B, C,  1, 12, 0xE8C7B756);
-	P(C, D, A, B,  2, 17, 0x242070DB);
-	P(B, C, D, A,  3, 22, 0xC1BDCEEE);
-	P(A, B, C, D,  4,  7, 0xF57C0FAF);
-	P(D, A, B, C,  5, 12, 0x4787C62A);
-	P(C, D, A, B,  6, 17, 0xA8304613);
-	P(B, C, D, A,  7, 22, 0xFD469501);
-	P(A, B, C, D,  8,  7, 0x698098D8);
-	P(D, A, B, C,  9, 12, 0x8B44F7AF);
-	P(C, D, A, B, 10, 17, 0xFFFF5BB1);
-	P(B, C, D, A, 11, 22, 0x895CD7BE);
-	P(A, B, C, D, 12,  7, 0x6B901122);
-	P(D, A, B, C, 13, 12, 0xFD987193);
-	P(C, D, A, B, 14, 17, 0xA679438E);
-	P(B, C, D, A, 15, 22, 0x49B40821);
-
-#undef F
-
-#define F(x, y, z) (y ^ (z & (x ^ y)))
-
-	P(A, B, C, D,  1,  5, 0xF61E2562);
-	P(D, A, B, C,  6,  9, 0xC040B340);
-	P(C, D, A, B, 11, 14, 0x265E5A51);
-	P(B, C, D, A,  0, 20, 0xE9B6C7AA);
-	P(A, B, C, D,  5,  5, 0xD62F105D);
-	P(D, A, B, C, 10,  9, 0x02441453);
-	P(C, D, A, B, 15, 14, 0xD8A1E681);
-	P(B, C, D, A,  4, 20, 0xE7D3FBC8);
-	P(A, B, C, D,  9,  5, 0x21E1CDE6);
-	P(D, A, B, C, 14,  9, 0xC33707D6);
-	P(C, D, A, B,  3, 14, 0xF4D50D87);
-	P(B, C, D, A,  8, 20, 0x455A14ED);
-	P(A, B, C, D, 13,  5, 0xA9E3E905);
-	P(D, A, B, C,  2,  9, 0xFCEFA3F8);
-	P(C, D, A, B,  7, 14, 0x676F02D9);
-	P(B, C, D, A, 12, 20, 0x8D2A4C8A);
-
-#undef F
-
-#define F(x, y, z) (x ^ y ^ z)
-
-	P(A, B, C, D,  5,  4, 0xFFFA3942);
-	P(D, A, B, C,  8, 11, 0x8771F681);
-	P(C, D, A, B, 11, 16, 0x6D9D6122);
-	P(B, C, D, A, 14, 23, 0xFDE5380C);
-	P(A, B, C, D,  1,  4, 0xA4BEEA44);
-	P(D, A, B, C,  4, 11, 0x4BDECFA9);
-	P(C, D, A, B,  7, 16, 0xF6BB4B60);
-	P(B, C, D, A, 10, 23, 0xBEBFBC70);
-	P(A, B, C, D, 13,  4, 0x289B7EC6);
-	P(D, A, B, C,  0, 11, 0xEAA127FA);
-	P(C, D, A, B,  3, 16, 0xD4EF3085);
-	P(B, C, D, A,  6, 23, 0x04881D05);
-	P(A, B, C, D,  9,  4, 0xD9D4D039);
-	P(D, A, B, C, 12, 11, 0xE6DB99E5);
-	P(C, D, A, B, 15, 16, 0x1FA27CF8);
-	P(B, C, D, A,  2, 23, 0xC4AC5665);
-
-#undef F
-
-#define F(x, y, z) (y ^ (x | ~z))
-
-	P(A, B, C, D,  0,  6, 0xF4292244);
-	P(D, A, B, C,  7, 10, 0x432AFF97);
-	P(C, D, A, B, 14, 15, 0xAB9423A7);
-	P(B, C, D, A,  5, 21, 0xFC93A039);
-	P(A, B, C, D, 12,  6, 0x655B59C3);
-	P(D, A, B, C,  3, 10, 0x8F0CCC92);
-	P(C, D, A, B, 10, 15, 0xFFEFF47D);
-	P(B, C, D, A,  1, 21, 0x85845DD1);
-	P(A, B, C, D,  8,  6, 0x6FA87E4F);
-	P(D, A, B, C, 15, 10, 0xFE2CE6E0);
-	P(C, D, A, B,  6, 15, 0xA3014314);
-	P(B, C, D, A, 13, 21, 0x4E0811A1);
-	P(A, B, C, D,  4,  6, 0xF7537E82);
-	P(D, A, B, C, 11, 10, 0xBD3AF235);
-	P(C, D, A, B,  2, 15, 0x2AD7D2BB);
-	P(B, C, D, A,  9, 21, 0xEB86D391);
-
-#undef F
-
-	ctx->state[0] += A;
-	ctx->state[1] += B;
-	ctx->state[2] += C;
-	ctx->state[3] += D;
+void MD5::addToTotal(uint32 size) {
+	_total[0] += size;
+	if (_total[0] < size)
+		_total[1]++;
 }
 
-void md5_update(md5_context *ctx, const uint8 *input, uint32 length) {
+void MD5::update(const void *data, uint32 size) {
+	const uint8 *input = (const uint8 *)data;
 	uint32 left, fill;
 
-	if (!length)
+	if (!size)
 		return;
 
-	left = ctx->total[0] & 0x3F;
+	left = _total[0] & 0x3F;
 	fill = 64 - left;
 
-	ctx->total[0] += length;
-	ctx->total[0] &= 0xFFFFFFFF;
-
-	if (ctx->total[0] < length)
-		ctx->total[1]++;
+	addToTotal(size);
 
-	if (left && length >= fill) {
-		memcpy((void *)(ctx->buffer + left), (const void *)input, fill);
-		md5_process(ctx, ctx->buffer);
-		length -= fill;
-		input  += fill;
+	if (left && size >= fill) {
+		memcpy(_buffer + left, input, fill);
+		processBlocks(_state, _buffer, 1);
+		size -= fill;
+		input += fill;
 		left = 0;
 	}
 
-	while (length >= 64) {
-		md5_process(ctx, input);
-		length -= 64;
-		input  += 64;
+	if (size >= 64) {
+		processBlocks(_state, input, size / 64);
+		input += size & ~0x3F;
+		size &= 0x3F;
 	}
 
-	if (length) {
-		memcpy((void *)(ctx->buffer + left), (const void *)input, length);
+	if (size)
+		memcpy(_buffer + left, input, size);
+}
+
+void MD5::updatePair(MD5 &first, const void *firstData, MD5 &second, const void *secondData, uint32 size) {
+	// Blocks can only be hashed straight from the input when neither
+	// computation has buffered a partial block.
+	if ((first._total[0] & 0x3F) || (second._total[0] & 0x3F) || size < 64) {
+		first.update(firstData, size);
+		second.update(secondData, size);
+		return;
 	}
+
+	const uint32 blocksSize = size & ~0x3F;
+	processBlockPairs(first._state, (const uint8 *)firstData, second._state, (const uint8 *)secondData, blocksSize / 64);
+	first.addToTotal(blocksSize);
+	second.addToTotal(blocksSize);
+
+	first.update((const uint8 *)firstData + blocksSize, size - blocksSize);
+	second.update((const uint8 *)secondData + blocksSize, size - blocksSize);
 }
 
 static const uint8 md5_padding[64] = {
@@ -219,62 +275,75 @@ static const uint8 md5_padding[64] = {
 	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
-void md5_finish(md5_context *ctx, uint8 digest[16]) {
+void MD5::finish(uint8 digest[16]) {
 	uint32 last, padn;
 	uint32 high, low;
 	uint8 msglen[8];
 
-	high = (ctx->total[0] >> 29) | (ctx->total[1] << 3);
-	low  = (ctx->total[0] <<  3);
+	high = (_total[0] >> 29) | (_total[1] << 3);
+	low  = (_total[0] <<  3);
 
 	PUT_UINT32(low,  msglen, 0);
 	PUT_UINT32(high, msglen, 4);
 
-	last = ctx->total[0] & 0x3F;
+	last = _total[0] & 0x3F;
 	padn = (last < 56) ? (56 - last) : (120 - last);
 
-	md5_update(ctx, md5_padding, padn);
-	md5_update(ctx, msglen, 8);
+	update(md5_padding, padn);
+	update(msglen, 8);
 
-	PUT_UINT32(ctx->state[0], digest,  0);
-	PUT_UINT32(ctx->state[1], digest,  4);
-	PUT_UINT32(ctx->state[2], digest,  8);
-	PUT_UINT32(ctx->state[3], digest, 12);
+	PUT_UINT32(_state[0], digest,  0);
+	PUT_UINT32(_state[1], digest,  4);
+	PUT_UINT32(_state[2], digest,  8);
+	PUT_UINT32(_state[3], digest, 12);
 }
 
+String MD5::finishAsString() {
+	String md5;
+	uint8 digest[16];
+	finish(digest);
+	for (int i = 0; i < 16; i++) {
+		md5 += String::format("%02x", (int)digest[i]);
+	}
 
-bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length) {
+	return md5;
+}
 
-#ifdef DISABLE_MD5
-	memset(digest, 0, 16);
-#else
-	md5_context ctx;
-	int i;
-	unsigned char buf[1000];
-	bool restricted = (length != 0);
-	uint32 readlen;
 
-	if (!restricted || sizeof(buf) <= length)
-		readlen = sizeof(buf);
-	else
-		readlen = length;
+enum {
+	kReadChunkSize = 32 * 1024
+};
 
-	md5_starts(&ctx);
+/**
+ * Read the next chunk of data to hash. 'left' is the number of bytes still
+ * to hash, or 0 if the whole stream is to be hashed.
+ */
+static uint32 readChunk(ReadStream &stream, byte *buffer, uint32 bufferSize, bool restricted, uint32 &left) {
+	if (restricted && !left)
+		return 0;
+
+	const uint32 size = stream.read(buffer, restricted ? MIN(left, bufferSize) : bufferSize);
+	if (restricted)
+		left -= size;
+	return size;
+}
 
-	while ((i = stream.read(buf, readlen)) > 0) {
-		md5_update(&ctx, buf, i);
+bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length) {
 
-		if (restricted) {
-			length -= i;
-			if (length == 0)
-				break;
+#ifdef DISABLE_MD5
+	memset(digest, 0, 16);
+#else
+	const bool restricted = (length != 0);
+	const uint32 bufferSize = (restricted && length < kReadChunkSize) ? length : (uint32)kReadChunkSize;
+	byte *buffer = new byte[bufferSize];
+	MD5 md5;
+	uint32 size;
 
-			if (sizeof(buf) > length)
-				readlen = length;
-		}
-	}
+	while ((size = readChunk(stream, buffer, bufferSize, restricted, length)) > 0)
+		md5.update(buffer, size);
 
-	md5_finish(&ctx, digest);
+	delete[] buffer;
+	md5.finish(digest);
 #endif
 	return true;
 }
@@ -291,4 +360,43 @@ String computeStreamMD5AsString(ReadStream &stream, uint32 length) {
 	return md5;
 }
 
+bool computeStreamsMD5(ReadStream *const *streams, uint count, uint8 (*digests)[16], uint32 length) {
+	uint i = 0;
+
+#ifndef DISABLE_MD5
+	if (count >= 2) {
+		const bool restricted = (length != 0);
+		const uint32 bufferSize = (restricted && length < kReadChunkSize) ? length : (uint32)kReadChunkSize;
+		byte *firstBuffer = new byte[2 * bufferSize];
+		byte *secondBuffer = firstBuffer + bufferSize;
+
+		for (; i + 1 < count; i += 2) {
+			MD5 first, second;
+			uint32 firstLeft = length, secondLeft = length;
+			uint32 firstSize, secondSize;
+
+			do {
+				firstSize = readChunk(*streams[i], firstBuffer, bufferSize, restricted, firstLeft);
+				secondSize = readChunk(*streams[i + 1], secondBuffer, bufferSize, restricted, secondLeft);
+
+				const uint32 common = MIN(firstSize, secondSize);
+				MD5::updatePair(first, firstBuffer, second, secondBuffer, common);
+				first.update(firstBuffer + common, firstSize - common);
+				second.update(secondBuffer + common, secondSize - common);
+			} while (firstSize || secondSize);
+
+			first.finish(digests[i]);
+			second.finish(digests[i + 1]);
+		}
+
+		delete[] firstBuffer;
+	}
+#endif
+
+	for (; i < count; i++)
+		computeStreamMD5(*streams[i], digests[i], length);
+
+	return true;
+}
+
 } // End of namespace Common
@@ -29,6 +29,44 @@ namespace Common {
 class ReadStream;
 class String;
 
+/**
+ * Incremental MD5 computation. Feed the data with update(), in pieces of
+ * any size, and retrieve the checksum with finish().
+ */
+class MD5 {
+public:
+	MD5() { reset(); }
+
+	/** Start a new checksum computation. */
+	void reset();
+
+	/** Add the given data to the checksum. */
+	void update(const void *data, uint32 size);
+
+	/**
+	 * Add two buffers of the same size to two separate checksums. Both
+	 * computations are interleaved, which is faster than two calls to
+	 * update() on CPUs that can execute several instructions at once.
+	 */
+	static void updatePair(MD5 &first, const void *firstData, MD5 &second, const void *secondData, uint32 size);
+
+	/**
+	 * Finish the computation and store the 128 bit checksum in digest.
+	 * Call reset() before reusing the object.
+	 */
+	void finish(uint8 digest[16]);
+
+	/** Finish the computation and return the checksum as a lowercase hex string. */
+	String finishAsString();
+
+private:
+	void addToTotal(uint32 size);
+
+	uint32 _total[2];
+	uint32 _state[4];
+	uint8 _buffer[64];
+};
+
 /**
  * Compute the MD5 checksum of the content of the given ReadStream.
  * The 128 bit MD5 checksum is returned directly in the array digest.
@@ -53,6 +91,18 @@ bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length = 0);
  */
 String computeStreamMD5AsString(ReadStream &stream, uint32 length = 0);
 
+/**
+ * Compute the MD5 checksums of the contents of several ReadStreams at
+ * once. This is faster than hashing the streams one after the other,
+ * see MD5::updatePair().
+ * @param[in] streams	the streams of whose data the MD5s are computed
+ * @param[in] count	the number of streams
+ * @param[out] digests	the computed MD5 checksums, one per stream
+ * @param[in] length	the number of bytes of each stream for which to compute the checksum; 0 means all
+ * @return true on success, false if an error occurred
+ */
+bool computeStreamsMD5(ReadStream *const *streams, uint count, uint8 (*digests)[16], uint32 length = 0);
+
 } // End of namespace Common
 
 #endif
@@ -25,6 +25,7 @@
 #include "common/memstream.h"
 #include "common/substream.h"
 #include "common/str.h"
+#include "common/util.h"
 
 namespace Common {
 
@@ -40,6 +41,35 @@ SeekableReadStream *ReadStream::readStream(uint32 dataSize) {
 }
 
 
+bool SeekableReadStream::peekSpan(uint32 dataSize, StreamSpan &span) {
+	const int32 start = pos();
+	const bool success = readSpan(dataSize, span);
+	seek(start);
+	return success;
+}
+
+bool SeekableReadStream::readSpan(uint32 dataSize, StreamSpan &span) {
+	span.clear();
+
+	const byte *data = peekPointer(dataSize);
+	if (data) {
+		if (!skip(dataSize))
+			return false;
+		span._data = data;
+		span._size = dataSize;
+		return true;
+	}
+
+	byte *copy = (byte *)malloc(dataSize ? dataSize : 1);
+	if (!copy || read(copy, dataSize) != dataSize) {
+		free(copy);
+		return false;
+	}
+	span._data = span._copy = copy;
+	span._size = dataSize;
+	return true;
+}
+
 uint32 MemoryReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Read at most as many bytes as are still available...
 	if (dataSize > _size - _pos) {
@@ -240,6 +270,12 @@ bool SeekableSubReadStream::seek(int32 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::peekPointer(uint32 dataSize) {
+	if (dataSize > _end - _pos || !_parentStream->seek(_pos))
+		return 0;
+	return _parentStream->peekPointer(dataSize);
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
@@ -432,6 +468,196 @@ SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStr
 
 namespace {
 
+/**
+ * Wrapper class which buffers a SeekableReadStream in a few independent
+ * blocks. A block is filled with more data each time the stream is read
+ * on from where the previous block ended, and the least recently used
+ * block is refilled when reading from a position none of them holds.
+ * @see wrapAdaptiveBufferedSeekableReadStream
+ */
+class AdaptiveBufferedSeekableReadStream : public SeekableReadStream {
+protected:
+	enum {
+		kBlockCount = 4,
+		kMinBlockSize = 4096,
+		kMaxBlockSize = 256 * 1024
+	};
+
+	struct Block {
+		int32 start;
+		uint32 size;
+		uint32 lastUse;
+		byte *data;
+		uint32 capacity;
+	};
+
+	DisposablePtr<SeekableReadStream> _parentStream;
+	Block _blocks[kBlockCount];
+	int32 _pos;
+	const int32 _size;
+	uint32 _fillSize;		///< Size of the next block fill
+	int32 _sequentialPos;	///< End of the data last read from the parent
+	uint32 _useCounter;
+	bool _eos;
+
+	Block *findBlock(int32 position);
+	Block *fillBlock(int32 position);
+
+public:
+	AdaptiveBufferedSeekableReadStream(SeekableReadStream *parentStream, DisposeAfterUse::Flag disposeParentStream);
+	virtual ~AdaptiveBufferedSeekableReadStream();
+
+	virtual bool eos() const { return _eos; }
+	virtual bool err() const { return _parentStream->err(); }
+	virtual void clearErr() { _eos = false; _parentStream->clearErr(); }
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize);
+
+	virtual int32 pos() const { return _pos; }
+	virtual int32 size() const { return _size; }
+	virtual bool seek(int32 offset, int whence = SEEK_SET);
+};
+
+AdaptiveBufferedSeekableReadStream::AdaptiveBufferedSeekableReadStream(SeekableReadStream *parentStream, DisposeAfterUse::Flag disposeParentStream)
+	: _parentStream(parentStream, disposeParentStream),
+	_pos(parentStream->pos()),
+	_size(parentStream->size()),
+	_fillSize(kMinBlockSize),
+	_sequentialPos(-1),
+	_useCounter(0),
+	_eos(false) {
+
+	for (int i = 0; i < kBlockCount; i++) {
+		_blocks[i].start = 0;
+		_blocks[i].size = 0;
+		_blocks[i].lastUse = 0;
+		_blocks[i].data = 0;
+		_blocks[i].capacity = 0;
+	}
+}
+
+AdaptiveBufferedSeekableReadStream::~AdaptiveBufferedSeekableReadStream() {
+	for (int i = 0; i < kBlockCount; i++)
+		free(_blocks[i].data);
+}
+
+AdaptiveBufferedSeekableReadStream::Block *AdaptiveBufferedSeekableReadStream::findBlock(int32 position) {
+	for (int i = 0; i < kBlockCount; i++) {
+		Block &block = _blocks[i];
+		if (position >= block.start && position < block.start + (int32)block.size) {
+			block.lastUse = ++_useCounter;
+			return &block;
+		}
+	}
+	return 0;
+}
+
+AdaptiveBufferedSeekableReadStream::Block *AdaptiveBufferedSeekableReadStream::fillBlock(int32 position) {
+	// Read further ahead while the stream is consumed sequentially, and
+	// go back to small fills once it is not
+	if (position == _sequentialPos)
+		_fillSize = MIN<uint32>(_fillSize * 2, kMaxBlockSize);
+	else
+		_fillSize = kMinBlockSize;
+
+	Block *block = &_blocks[0];
+	for (int i = 1; i < kBlockCount; i++) {
+		if (_blocks[i].lastUse < block->lastUse)
+			block = &_blocks[i];
+	}
+
+	if (block->capacity < _fillSize) {
+		byte *data = (byte *)realloc(block->data, _fillSize);
+		if (!data)
+			return 0;
+		block->data = data;
+		block->capacity = _fillSize;
+	}
+
+	block->size = 0;
+	if (!_parentStream->seek(position))
+		return 0;
+	block->start = position;
+	block->size = _parentStream->read(block->data, MIN<uint32>(_fillSize, _size - position));
+	block->lastUse = ++_useCounter;
+	_sequentialPos = position + block->size;
+
+	return block->size ? block : 0;
+}
+
+uint32 AdaptiveBufferedSeekableReadStream::read(void *dataPtr, uint32 dataSize) {
+	byte *dst = (byte *)dataPtr;
+	uint32 alreadyRead = 0;
+
+	while (alreadyRead < dataSize) {
+		const uint32 left = dataSize - alreadyRead;
+		Block *block = findBlock(_pos);
+
+		// Reads of at least a block's size bypass the buffers
+		if (!block && left >= _fillSize) {
+			uint32 n = 0;
+			if (_parentStream->seek(_pos))
+				n = _parentStream->read(dst + alreadyRead, left);
+			_pos += n;
+			_sequentialPos = _pos;
+			alreadyRead += n;
+			break;
+		}
+
+		if (!block)
+			block = fillBlock(_pos);
+		if (!block)
+			break;
+
+		const uint32 offset = _pos - block->start;
+		const uint32 n = MIN<uint32>(left, block->size - offset);
+		memcpy(dst + alreadyRead, block->data + offset, n);
+		_pos += n;
+		alreadyRead += n;
+	}
+
+	if (alreadyRead < dataSize)
+		_eos = true;
+	return alreadyRead;
+}
+
+bool AdaptiveBufferedSeekableReadStream::seek(int32 offset, int whence) {
+	switch (whence) {
+	case SEEK_CUR:
+		offset += _pos;
+		break;
+	case SEEK_END:
+		offset += _size;
+		break;
+	default:
+		break;
+	}
+
+	if (offset < 0 || offset > _size)
+		return false;
+
+	_pos = offset;
+	_eos = false;
+	return true;
+}
+
+} // End of anonymous namespace
+
+SeekableReadStream *wrapAdaptiveBufferedSeekableReadStream(SeekableReadStream *parentStream, DisposeAfterUse::Flag disposeParentStream) {
+	if (!parentStream)
+		return 0;
+
+	// Streams holding their data in memory do not gain anything
+	if (disposeParentStream == DisposeAfterUse::YES && parentStream->peekPointer(0))
+		return parentStream;
+
+	return new AdaptiveBufferedSeekableReadStream(parentStream, disposeParentStream);
+}
+
+#pragma mark -
+
+namespace {
+
 /**
  * Wrapper class which adds buffering to any WriteStream.
  */
@@ -441,6 +667,7 @@ protected:
 	byte *_buf;
 	uint32 _pos;
 	const uint32 _bufSize;
+	bool _err;
 
 	/**
 	 * Write out the data in the buffer.
@@ -454,8 +681,10 @@ protected:
 
 		if (bytesToWrite) {
 			_pos = 0;
-			if (_parentStream->write(_buf, bytesToWrite) != bytesToWrite)
+			if (_parentStream->write(_buf, bytesToWrite) != bytesToWrite) {
+				_err = true;
 				return false;
+			}
 		}
 		return true;
 	}
@@ -464,7 +693,8 @@ public:
 	BufferedWriteStream(WriteStream *parentStream, uint32 bufSize)
 		: _parentStream(parentStream),
 		_pos(0),
-		_bufSize(bufSize) {
+		_bufSize(bufSize),
+		_err(false) {
 
 		assert(parentStream);
 		_buf = new byte[bufSize];
@@ -472,33 +702,46 @@ public:
 	}
 
 	virtual ~BufferedWriteStream() {
-		const bool flushResult = flushBuffer();
-		assert(flushResult);
+		// Errors can't be reported anymore at this point; callers which
+		// care call finalize() first.
+		flushBuffer();
 
 		delete _parentStream;
 
 		delete[] _buf;
 	}
 
+	virtual bool err() const { return _err || _parentStream->err(); }
+
+	virtual void clearErr() {
+		_err = false;
+		_parentStream->clearErr();
+	}
+
 	virtual uint32 write(const void *dataPtr, uint32 dataSize) {
 		// check if we have enough space for writing to the buffer
 		if (_bufSize - _pos >= dataSize) {
 			memcpy(_buf + _pos, dataPtr, dataSize);
 			_pos += dataSize;
 		} else if (_bufSize >= dataSize) {	// check if we can flush the buffer and load the data
-			const bool flushResult = flushBuffer();
-			assert(flushResult);
+			if (!flushBuffer())
+				return 0;
 			memcpy(_buf, dataPtr, dataSize);
 			_pos += dataSize;
 		} else	{	// too big for our buffer
-			const bool flushResult = flushBuffer();
-			assert(flushResult);
+			if (!flushBuffer())
+				return 0;
 			return _parentStream->write(dataPtr, dataSize);
 		}
 		return dataSize;
 	}
 
-	virtual bool flush() { return flushBuffer(); }
+	virtual bool flush() { return flushBuffer() && _parentStream->flush(); }
+
+	virtual void finalize() {
+		flushBuffer();
+		_parentStream->finalize();
+	}
 
 };
 
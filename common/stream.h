@@ -24,6 +24,7 @@
 #define COMMON_STREAM_H
 
 #include "common/endian.h"
+#include "common/noncopyable.h"
 #include "common/scummsys.h"
 #include "common/str.h"
 
@@ -31,6 +32,38 @@ namespace Common {
 
 class SeekableReadStream;
 
+/**
+ * A block of stream data, as returned by SeekableReadStream::peekSpan()
+ * and SeekableReadStream::readSpan(). The data is either borrowed from the
+ * stream, and then only valid as long as the stream exists, or a copy
+ * owned by the span.
+ */
+class StreamSpan : NonCopyable {
+public:
+	StreamSpan() : _data(0), _size(0), _copy(0) {}
+	~StreamSpan() { clear(); }
+
+	const byte *data() const { return _data; }
+	uint32 size() const { return _size; }
+
+	/** Whether the data points into the storage of the stream. */
+	bool isBorrowed() const { return _data && !_copy; }
+
+	void clear() {
+		free(_copy);
+		_data = 0;
+		_size = 0;
+		_copy = 0;
+	}
+
+private:
+	friend class SeekableReadStream;
+
+	const byte *_data;
+	uint32 _size;
+	byte *_copy;
+};
+
 /**
  * Virtual base class for both ReadStream and WriteStream.
  */
@@ -371,6 +404,38 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Gives direct access to the next dataSize bytes of the stream, for
+	 * streams which have all their data in memory, like memory streams or
+	 * memory mapped files. The position indicator is not changed.
+	 *
+	 * The returned data is owned by the stream and stays valid until the
+	 * stream is destroyed. Callers must fall back to read() when 0 is
+	 * returned.
+	 *
+	 * @param dataSize	the number of bytes needed
+	 * @return a pointer to the data at the current position, or 0 if the
+	 *         stream cannot provide one or fewer than dataSize bytes are left
+	 */
+	virtual const byte *peekPointer(uint32 dataSize) { return 0; }
+
+	/**
+	 * Makes the next dataSize bytes of the stream available in span,
+	 * without changing the position indicator. When the stream can provide
+	 * them with peekPointer(), no copy is made. Otherwise they are read
+	 * into a buffer owned by span.
+	 *
+	 * @return true on success, false if fewer than dataSize bytes could be
+	 *         read, in which case span is empty
+	 */
+	bool peekSpan(uint32 dataSize, StreamSpan &span);
+
+	/**
+	 * Like peekSpan(), but also advances the position indicator past the
+	 * data, like read() would.
+	 */
+	bool readSpan(uint32 dataSize, StreamSpan &span);
+
 	/**
 	 * Reads at most one less than the number of characters specified
 	 * by bufSize from the and stores them in the string buf. Reading
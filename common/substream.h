@@ -77,6 +77,8 @@ public:
 	virtual int32 size() const { return _end - _begin; }
 
 	virtual bool seek(int32 offset, int whence = SEEK_SET);
+
+	virtual const byte *peekPointer(uint32 dataSize);
 };
 
 /**
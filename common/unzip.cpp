@@ -105,9 +105,11 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/substream.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/ptr.h"
 
 #if defined(STRICTUNZIP) || defined(STRICTZIPUNZIP)
 /* like the STRICT of WIN32, we define a pointer that cannot be converted
@@ -379,6 +381,7 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _sharedStream;	/* owns _stream, shared with member streams */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -541,6 +544,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	int err=UNZ_OK;
 
 	us->_stream = stream;
+	us->_sharedStream = Common::SharedPtr<Common::SeekableReadStream>(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos==0)
@@ -592,7 +596,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return NULL;
 	}
@@ -641,7 +644,6 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != NULL)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
 	delete s;
 	return UNZ_OK;
 }
@@ -1416,6 +1418,275 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+/**
+ * Raw data of a member in a zip archive. The stream keeps the archive's
+ * stream alive, and re-seeks it before each read, so that any number of
+ * members can be read at the same time, also after the archive is deleted.
+ */
+class ZipMemberReadStream : public SafeSeekableSubReadStream {
+	SharedPtr<SeekableReadStream> _archiveStream;
+
+public:
+	ZipMemberReadStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 begin, uint32 end)
+		: SafeSeekableSubReadStream(archiveStream.get(), begin, end), _archiveStream(archiveStream) {
+	}
+};
+
+#ifdef USE_ZLIB
+
+/**
+ * Seekable stream inflating a deflated zip member on demand.
+ *
+ * Only a 32KB window of decompressed data is kept in memory. While the
+ * member is decompressed for the first time, restart points are recorded
+ * every kRestartSpan bytes at deflate block boundaries. Seeking backwards
+ * further than the window resumes decompression from the closest restart
+ * point, instead of from the start of the member.
+ */
+class ZipInflateReadStream : public SeekableReadStream {
+public:
+	ZipInflateReadStream(SeekableReadStream *compressed, uint32 size, uint32 crc);
+	~ZipInflateReadStream();
+
+	bool err() const { return _err; }
+	void clearErr() { _eos = false; }
+	bool eos() const { return _eos; }
+
+	uint32 read(void *dataPtr, uint32 dataSize);
+
+	int32 pos() const { return _decodedPos - _pending; }
+	int32 size() const { return _size; }
+	bool seek(int32 offset, int whence = SEEK_SET);
+
+private:
+	enum {
+		kWindowSize = 32768,		///< Largest back reference of deflate
+		kInputSize = 4096,
+		kRestartSpan = 512 * 1024	///< Uncompressed bytes between restart points
+	};
+
+	struct RestartPoint {
+		uint32 out;		///< Uncompressed position
+		uint32 in;		///< Compressed position of the first complete byte
+		int bits;		///< Bits of the byte before 'in' still to be decoded
+		byte *window;	///< Preceding kWindowSize uncompressed bytes, 0 at the start
+	};
+
+	bool decodeMore();
+	void addRestartPoint();
+	bool restart(const RestartPoint &point);
+	uint32 copyPending(byte *dst, uint32 count);
+
+	ScopedPtr<SeekableReadStream> _compressed;
+	const uint32 _size;
+	const uint32 _crc;
+
+	z_stream _zs;
+	bool _zsInitialized;
+	byte _input[kInputSize];
+	uint32 _inputStart;		///< Compressed position at which _zs.total_in is 0
+
+	byte *_window;			///< Circular buffer of recent output
+	uint32 _windowPos;		///< Write position in _window
+	uint32 _windowFill;		///< Valid bytes in _window
+	uint32 _pending;		///< Decoded bytes before _windowPos not read yet
+	uint32 _decodedPos;		///< Uncompressed position of _windowPos
+
+	uint32 _crcData;
+	bool _crcValid;			///< _crcData covers everything up to _decodedPos
+	bool _streamEnd;
+	bool _eos;
+	bool _err;
+
+	Array<RestartPoint> _restartPoints;
+};
+
+ZipInflateReadStream::ZipInflateReadStream(SeekableReadStream *compressed, uint32 size, uint32 crc)
+	: _compressed(compressed), _size(size), _crc(crc), _zsInitialized(false), _inputStart(0),
+	  _windowPos(0), _windowFill(0), _pending(0), _decodedPos(0),
+	  _crcData(0), _crcValid(true), _streamEnd(false), _eos(false), _err(false) {
+	_window = new byte[kWindowSize];
+
+	memset(&_zs, 0, sizeof(_zs));
+	// Negative window bits: raw deflate data without zlib header
+	_err = (inflateInit2(&_zs, -MAX_WBITS) != Z_OK);
+	_zsInitialized = !_err;
+
+	RestartPoint start = { 0, 0, 0, 0 };
+	_restartPoints.push_back(start);
+}
+
+ZipInflateReadStream::~ZipInflateReadStream() {
+	if (_zsInitialized)
+		inflateEnd(&_zs);
+	for (uint i = 0; i < _restartPoints.size(); i++)
+		delete[] _restartPoints[i].window;
+	delete[] _window;
+}
+
+uint32 ZipInflateReadStream::copyPending(byte *dst, uint32 count) {
+	if (count > _pending)
+		count = _pending;
+
+	uint32 start = (_windowPos + kWindowSize - _pending) % kWindowSize;
+	uint32 left = count;
+	while (left) {
+		const uint32 chunk = MIN<uint32>(left, kWindowSize - start);
+		if (dst) {
+			memcpy(dst, _window + start, chunk);
+			dst += chunk;
+		}
+		start = (start + chunk) % kWindowSize;
+		left -= chunk;
+	}
+
+	_pending -= count;
+	return count;
+}
+
+bool ZipInflateReadStream::decodeMore() {
+	if (_err || _streamEnd || _decodedPos >= _size)
+		return false;
+
+	if (_zs.avail_in == 0) {
+		_zs.next_in = _input;
+		_zs.avail_in = _compressed->read(_input, kInputSize);
+	}
+
+	if (_windowPos == kWindowSize)
+		_windowPos = 0;
+	_zs.next_out = _window + _windowPos;
+	_zs.avail_out = kWindowSize - _windowPos;
+
+	// Z_BLOCK makes inflate() stop at block boundaries, where restart
+	// points can be taken
+	const int result = inflate(&_zs, Z_BLOCK);
+	const uint32 produced = (kWindowSize - _windowPos) - _zs.avail_out;
+
+	if (_crcValid)
+		_crcData = crc32(_crcData, _window + _windowPos, produced);
+	_windowPos += produced;
+	_windowFill = MIN<uint32>(_windowFill + produced, kWindowSize);
+	_pending += produced;
+	_decodedPos += produced;
+
+	if (result == Z_STREAM_END) {
+		_streamEnd = true;
+	} else if (result != Z_OK) {
+		// Z_BUF_ERROR: the member data ended too early
+		_err = true;
+		return produced != 0;
+	} else if ((_zs.data_type & 128) && !(_zs.data_type & 64) &&
+	           _decodedPos >= _restartPoints.back().out + kRestartSpan) {
+		addRestartPoint();
+	}
+
+	if (_crcValid && (_streamEnd || _decodedPos >= _size) && _crcData != _crc) {
+		warning("ZipInflateReadStream: CRC mismatch");
+		_err = true;
+	}
+
+	return true;
+}
+
+void ZipInflateReadStream::addRestartPoint() {
+	RestartPoint point;
+	point.out = _decodedPos;
+	point.in = _inputStart + _zs.total_in;
+	point.bits = _zs.data_type & 7;
+	point.window = new byte[kWindowSize];
+
+	// Unroll the circular window, oldest byte first
+	const uint32 wrapPos = _windowPos % kWindowSize;
+	memcpy(point.window, _window + wrapPos, kWindowSize - wrapPos);
+	memcpy(point.window + kWindowSize - wrapPos, _window, wrapPos);
+
+	_restartPoints.push_back(point);
+}
+
+bool ZipInflateReadStream::restart(const RestartPoint &point) {
+	if (!_zsInitialized || inflateReset(&_zs) != Z_OK)
+		return false;
+
+	_zs.avail_in = 0;
+	if (!_compressed->seek(point.in - (point.bits ? 1 : 0)))
+		return false;
+	if (point.bits) {
+		const byte value = _compressed->readByte();
+		if (inflatePrime(&_zs, point.bits, value >> (8 - point.bits)) != Z_OK)
+			return false;
+	}
+	if (point.window && inflateSetDictionary(&_zs, point.window, kWindowSize) != Z_OK)
+		return false;
+
+	_inputStart = point.in;
+	_windowPos = 0;
+	_windowFill = 0;
+	_pending = 0;
+	_decodedPos = point.out;
+	_crcData = 0;
+	_crcValid = (point.out == 0);
+	_streamEnd = false;
+	return true;
+}
+
+uint32 ZipInflateReadStream::read(void *dataPtr, uint32 dataSize) {
+	byte *dst = (byte *)dataPtr;
+	uint32 total = 0;
+
+	while (total < dataSize) {
+		if (!_pending && !decodeMore()) {
+			_eos = true;
+			break;
+		}
+		total += copyPending(dst + total, dataSize - total);
+	}
+
+	return total;
+}
+
+bool ZipInflateReadStream::seek(int32 offset, int whence) {
+	int32 target = offset;
+	if (whence == SEEK_CUR)
+		target += pos();
+	else if (whence == SEEK_END)
+		target += _size;
+
+	if (target < 0 || (uint32)target > _size)
+		return false;
+
+	_eos = false;
+
+	// Still in the window of recent output
+	const uint32 newPos = target;
+	if (newPos <= _decodedPos && _decodedPos - newPos <= _windowFill) {
+		_pending = _decodedPos - newPos;
+		return true;
+	}
+
+	// Resume from the closest restart point if there is one between the
+	// current position and the target, or if we need to go back
+	uint i = _restartPoints.size() - 1;
+	while (_restartPoints[i].out > newPos)
+		i--;
+	if (newPos < (uint32)pos() || _restartPoints[i].out > _decodedPos) {
+		if (!restart(_restartPoints[i])) {
+			_err = true;
+			return false;
+		}
+	}
+
+	while ((uint32)pos() < newPos) {
+		if (!_pending && !decodeMore())
+			return false;
+		copyPending(0, newPos - pos());
+	}
+
+	return true;
+}
+
+#endif  // USE_ZLIB
+
 
 class ZipArchive : public Archive {
 	unzFile _zipFile;
@@ -1486,32 +1757,33 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return 0;
 
-	unz_file_info fileInfo;
 	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return 0;
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
-		return 0;
-
-	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
-	assert(buffer);
-
-	if (unzReadCurrentFile(_zipFile, buffer, fileInfo.uncompressed_size) != (int)fileInfo.uncompressed_size) {
-		free(buffer);
-		return 0;
-	}
-
-	if (unzCloseCurrentFile(_zipFile) != UNZ_OK) {
-		free(buffer);
+	// Only take the location of the member data from the opened file; the
+	// returned stream reads it independently of the archive.
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	const file_in_zip_read_info_s *const info = archive->pfile_in_zip_read;
+	const uint32 begin = info->pos_in_zipfile + info->byte_before_the_zipfile;
+	const uint32 compressedSize = info->rest_read_compressed;
+	const uint32 uncompressedSize = info->rest_read_uncompressed;
+	const uint32 crc = info->crc32_wait;
+	const bool stored = (info->compression_method == 0);
+
+	if (unzCloseCurrentFile(_zipFile) != UNZ_OK)
 		return 0;
-	}
 
-	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
+	SeekableReadStream *data = new ZipMemberReadStream(archive->_sharedStream, begin, begin + compressedSize);
+	if (stored)
+		return data;
 
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
+#ifdef USE_ZLIB
+	return new ZipInflateReadStream(data, uncompressedSize, crc);
+#else
+	// unzOpenCurrentFile() refuses compressed members without zlib
+	delete data;
+	return 0;
+#endif
 }
 
 Archive *makeZipArchive(const String &name) {
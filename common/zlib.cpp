@@ -147,10 +147,12 @@ bool inflateZlibInstallShield(byte *dst, uint dstLen, const byte *src, uint srcL
 class GZipReadStream : public SeekableReadStream {
 protected:
 	enum {
-		BUFSIZE = 16384		// 1 << MAX_WBITS
+		// 4 * (1 << MAX_WBITS). Only allocated for sources which can't
+		// hand out their data through peekPointer().
+		BUFSIZE = 65536
 	};
 
-	byte	_buf[BUFSIZE];
+	byte	*_buf;
 
 	ScopedPtr<SeekableReadStream> _wrapped;
 	z_stream _stream;
@@ -161,7 +163,7 @@ protected:
 
 public:
 
-	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0) : _wrapped(w), _stream() {
+	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0) : _buf(0), _wrapped(w), _stream() {
 		assert(w != 0);
 
 		// Verify file header is correct
@@ -192,13 +194,14 @@ public:
 		if (_zlibErr != Z_OK)
 			return;
 
-		// Setup input buffer
-		_stream.next_in = _buf;
+		// The input buffer is set up on the first read
+		_stream.next_in = 0;
 		_stream.avail_in = 0;
 	}
 
 	~GZipReadStream() {
 		inflateEnd(&_stream);
+		delete[] _buf;
 	}
 
 	bool err() const { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
@@ -215,8 +218,20 @@ public:
 		while (_zlibErr == Z_OK && _stream.avail_out) {
 			if (_stream.avail_in == 0 && !_wrapped->eos()) {
 				// If we are out of input data: Read more data, if available.
-				_stream.next_in = _buf;
-				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
+				// Sources which hold their data in memory are inflated from
+				// there directly, all at once.
+				const uint32 left = _wrapped->size() - _wrapped->pos();
+				const byte *data = left ? _wrapped->peekPointer(left) : 0;
+				if (data) {
+					_wrapped->skip(left);
+					_stream.next_in = const_cast<byte *>(data);
+					_stream.avail_in = left;
+				} else {
+					if (!_buf)
+						_buf = new byte[BUFSIZE];
+					_stream.next_in = _buf;
+					_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
+				}
 			}
 			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
 		}
@@ -264,7 +279,7 @@ public:
 			_zlibErr = inflateReset(&_stream);
 			if (_zlibErr != Z_OK)
 				return false;	// FIXME: STREAM REWRITE
-			_stream.next_in = _buf;
+			_stream.next_in = 0;
 			_stream.avail_in = 0;
 		}
 
@@ -367,6 +367,166 @@ void AdvancedMetaEngine::composeFileHashMap(FileMap &allFiles, const Common::FSL
 	}
 }
 
+namespace {
+
+enum {
+	kMaxCachedFileProperties = 8192,
+	kFilesHashedAtOnce = 2	///< See Common::computeStreamsMD5()
+};
+
+/**
+ * File properties of game files, keyed by the number of hashed bytes and
+ * the file path. Many engines look for the same file names, so detecting a
+ * directory would otherwise hash the same files over and over again, and
+ * the launcher rescans the same directories on every run. The cache is
+ * shared by all engines using the advanced detector, which live in plugins
+ * but call into this file of the executable, and it is kept next to the
+ * config file across runs.
+ *
+ * Entries are only used while the size and modification time of the file
+ * match, which are both queried without opening the file. Files without a
+ * (reliable) modification time are not cached.
+ */
+class ADFilePropertiesCache {
+public:
+	ADFilePropertiesCache() : _loaded(false), _dirty(false) {}
+
+	bool lookup(uint32 md5Bytes, const Common::FSNode &node, ADFileProperties &fileProps);
+	void store(uint32 md5Bytes, const Common::FSNode &node, const ADFileProperties &fileProps);
+	void save();
+
+private:
+	struct Entry {
+		uint32 md5Bytes;
+		uint32 stamp;
+		Common::String path;
+		ADFileProperties props;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	static Common::String makeKey(uint32 md5Bytes, const Common::String &path) {
+		return Common::String::format("%u %s", md5Bytes, path.c_str());
+	}
+
+	static Common::FSNode getCacheFile();
+	void load();
+
+	EntryMap _entries;
+	bool _loaded;
+	bool _dirty;
+};
+
+ADFilePropertiesCache &getFilePropertiesCache() {
+	static ADFilePropertiesCache cache;
+	return cache;
+}
+
+Common::FSNode ADFilePropertiesCache::getCacheFile() {
+	// Put it next to the config file, with a related name
+	Common::String path = g_system->getDefaultConfigFileName();
+	if (path.hasSuffix(".ini"))
+		path = Common::String(path.c_str(), path.size() - 4);
+	return Common::FSNode(path + "-md5.cache");
+}
+
+void ADFilePropertiesCache::load() {
+	_loaded = true;
+
+	Common::SeekableReadStream *stream = getCacheFile().createReadStream();
+	if (!stream)
+		return;
+
+	// One line per file: the number of hashed bytes, the file size, the
+	// modification time, the MD5 and the path
+	if (stream->readLine() == "# ScummVM detection cache 1") {
+		while (!stream->eos() && !stream->err() && _entries.size() < kMaxCachedFileProperties) {
+			const Common::String line = stream->readLine();
+			uint md5Bytes, stamp;
+			int size, pathStart = 0;
+			char md5[33];
+			if (sscanf(line.c_str(), "%u %d %u %32s %n", &md5Bytes, &size, &stamp, md5, &pathStart) != 4 || !pathStart)
+				continue;
+
+			const Common::String path = line.c_str() + pathStart;
+			Entry &entry = _entries[makeKey(md5Bytes, path)];
+			entry.md5Bytes = md5Bytes;
+			entry.stamp = stamp;
+			entry.path = path;
+			entry.props.size = size;
+			entry.props.md5 = md5;
+		}
+	}
+
+	delete stream;
+}
+
+void ADFilePropertiesCache::save() {
+	if (!_dirty)
+		return;
+	_dirty = false;
+
+	Common::WriteStream *stream = getCacheFile().createWriteStream();
+	if (!stream)
+		return;
+
+	stream->writeString("# ScummVM detection cache 1\n");
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		const Entry &entry = i->_value;
+		stream->writeString(Common::String::format("%u %d %u %s %s\n", entry.md5Bytes, entry.props.size,
+			entry.stamp, entry.props.md5.c_str(), entry.path.c_str()));
+	}
+
+	stream->finalize();
+	if (stream->err())
+		warning("Could not write the detection cache");
+	delete stream;
+}
+
+bool ADFilePropertiesCache::lookup(uint32 md5Bytes, const Common::FSNode &node, ADFileProperties &fileProps) {
+	const uint32 stamp = node.getModificationTime();
+	const int32 size = node.getFileSize();
+	if (!stamp || size < 0)
+		return false;
+
+	if (!_loaded)
+		load();
+
+	EntryMap::const_iterator cached = _entries.find(makeKey(md5Bytes, node.getPath()));
+	if (cached == _entries.end() || cached->_value.stamp != stamp || cached->_value.props.size != size)
+		return false;
+
+	fileProps = cached->_value.props;
+	return true;
+}
+
+void ADFilePropertiesCache::store(uint32 md5Bytes, const Common::FSNode &node, const ADFileProperties &fileProps) {
+	const uint32 stamp = node.getModificationTime();
+	if (!stamp || fileProps.md5.empty())
+		return;
+
+	if (!_loaded)
+		load();
+
+	const Common::String path = node.getPath();
+	const Common::String key = makeKey(md5Bytes, path);
+	if (_entries.size() >= kMaxCachedFileProperties && !_entries.contains(key))
+		_entries.clear();
+
+	Entry &entry = _entries[key];
+	entry.md5Bytes = md5Bytes;
+	entry.stamp = stamp;
+	entry.path = path;
+	entry.props = fileProps;
+	_dirty = true;
+}
+
+} // End of anonymous namespace
+
+void AdvancedMetaEngine::saveFilePropertiesCache() {
+	getFilePropertiesCache().save();
+}
+
 bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, ADFileProperties &fileProps) const {
 	// FIXME/TODO: We don't handle the case that a file is listed as a regular
 	// file and as one with resource fork.
@@ -385,13 +545,19 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	if (!allFiles.contains(fname))
 		return false;
 
+	const Common::FSNode &node = allFiles[fname];
+	ADFilePropertiesCache &cache = getFilePropertiesCache();
+	if (cache.lookup(_md5Bytes, node, fileProps))
+		return true;
+
 	Common::File testFile;
 
-	if (!testFile.open(allFiles[fname]))
+	if (!testFile.open(node))
 		return false;
 
 	fileProps.size = (int32)testFile.size();
 	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
+	cache.store(_md5Bytes, node, fileProps);
 	return true;
 }
 
@@ -405,7 +571,12 @@ ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, cons
 	debug(3, "Starting detection in dir '%s'", parent.getPath().c_str());
 
 	// Check which files are included in some ADGameDescription *and* are present.
-	// Compute MD5s and file sizes for these files.
+	// Compute MD5s and file sizes for these files. Regular files whose MD5
+	// is not cached yet are hashed afterwards, several at once.
+	ADFilePropertiesCache &cache = getFilePropertiesCache();
+	Common::Array<Common::String> toHash;
+	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> pending;
+
 	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameid != 0; descPtr += _descItemSize) {
 		g = (const ADGameDescription *)descPtr;
 
@@ -413,8 +584,14 @@ ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, cons
 			Common::String fname = fileDesc->fileName;
 			ADFileProperties tmp;
 
-			if (filesProps.contains(fname))
+			if (filesProps.contains(fname) || pending.contains(fname))
+				continue;
+
+			if (!(g->flags & ADGF_MACRESFORK) && allFiles.contains(fname) && !cache.lookup(_md5Bytes, allFiles[fname], tmp)) {
+				pending[fname] = true;
+				toHash.push_back(fname);
 				continue;
+			}
 
 			if (getFileProperties(parent, allFiles, *g, fname, tmp)) {
 				debug(3, "> '%s': '%s'", fname.c_str(), tmp.md5.c_str());
@@ -423,6 +600,33 @@ ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, cons
 		}
 	}
 
+	for (uint first = 0; first < toHash.size(); first += kFilesHashedAtOnce) {
+		Common::File files[kFilesHashedAtOnce];
+		Common::ReadStream *streams[kFilesHashedAtOnce];
+		Common::String names[kFilesHashedAtOnce];
+		uint count = 0;
+
+		for (uint j = first; j < toHash.size() && j < first + kFilesHashedAtOnce; j++) {
+			if (files[count].open(allFiles[toHash[j]])) {
+				streams[count] = &files[count];
+				names[count] = toHash[j];
+				count++;
+			}
+		}
+
+		uint8 digests[kFilesHashedAtOnce][16];
+		Common::computeStreamsMD5(streams, count, digests, _md5Bytes);
+
+		for (uint j = 0; j < count; j++) {
+			ADFileProperties &props = filesProps[names[j]];
+			props.size = (int32)files[j].size();
+			for (int k = 0; k < 16; k++)
+				props.md5 += Common::String::format("%02x", (int)digests[j][k]);
+			cache.store(_md5Bytes, allFiles[names[j]], props);
+			debug(3, "> '%s': '%s'", names[j].c_str(), props.md5.c_str());
+		}
+	}
+
 	ADGameDescList matched;
 	int maxFilesMatched = 0;
 	bool gotAnyMatchesWithAllFiles = false;
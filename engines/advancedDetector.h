@@ -266,6 +266,13 @@ public:
 
 	virtual const ExtraGuiOptions getExtraGuiOptions(const Common::String &target) const;
 
+	/**
+	 * Write the file sizes and MD5s computed while detecting games to disk,
+	 * if new ones were added, so that later runs don't need to compute them
+	 * again. This covers all engines using the advanced detector.
+	 */
+	static void saveFilePropertiesCache();
+
 protected:
 	// To be implemented by subclasses
 	virtual bool createInstance(OSystem *syst, Engine **engine, const ADGameDescription *desc) const = 0;
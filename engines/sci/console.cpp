@@ -33,6 +33,7 @@
 #include "sci/engine/savegame.h"
 #include "sci/engine/gc.h"
 #include "sci/engine/features.h"
+#include "sci/engine/profiler.h"
 #include "sci/sound/midiparser_sci.h"
 #include "sci/sound/music.h"
 #include "sci/sound/drivers/mididriver.h"
@@ -109,6 +110,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	DCmd_Register("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	DCmd_Register("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	DCmd_Register("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
+	DCmd_Register("view_cache",			WRAP_METHOD(Console, cmdViewCache));
 	DCmd_Register("list",				WRAP_METHOD(Console, cmdList));
 	DCmd_Register("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	DCmd_Register("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
@@ -206,6 +209,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	DCmd_Register("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	DCmd_Register("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
+	DCmd_Register("profiler",			WRAP_METHOD(Console, cmdProfiler));
 	DCmd_Register("vm_varlist",			WRAP_METHOD(Console, cmdVMVarlist));
 	DCmd_Register("vmvarlist",			WRAP_METHOD(Console, cmdVMVarlist));				// alias
 	DCmd_Register("vl",					WRAP_METHOD(Console, cmdVMVarlist));				// alias
@@ -348,6 +353,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	DebugPrintf(" resource_info - Shows info about a resource\n");
 	DebugPrintf(" resource_types - Shows the valid resource types\n");
+	DebugPrintf(" resource_cache - Shows the memory usage and hit rates of the resource cache\n");
+	DebugPrintf(" view_cache - Shows the memory usage and hit rate of the view and picture caches\n");
 	DebugPrintf(" list - Lists all the resources of a given type\n");
 	DebugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	DebugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
@@ -428,6 +435,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf("\n");
 	DebugPrintf("VM:\n");
 	DebugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	DebugPrintf(" selector_cache - Shows or resets the hit rate of the selector lookup cache\n");
+	DebugPrintf(" profiler - Profiles kernel functions and scripts\n");
 	DebugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	DebugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
 	DebugPrintf(" stack - Lists the specified number of stack elements\n");
@@ -792,6 +801,48 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	const ResourceManager *resMan = _engine->getResMan();
+	double hits = 0, misses = 0;
+
+	DebugPrintf("Resource cache: %u of %u KB used, %u KB locked, %u resources freed\n",
+		resMan->getCacheMemoryUsed() / 1024, resMan->getCacheBudget() / 1024,
+		resMan->getLockedMemory() / 1024, resMan->getCacheEvictions());
+	DebugPrintf("Type         Used KB  Budget KB      Hits    Misses\n");
+	for (int i = 0; i < kResourceTypeInvalid; i++) {
+		const ResourceType type = (ResourceType)i;
+		hits += resMan->getCacheHits(type);
+		misses += resMan->getCacheMisses(type);
+		if (!resMan->getCacheHits(type) && !resMan->getCacheMisses(type) && !resMan->getCacheMemoryUsed(type))
+			continue;
+
+		DebugPrintf("%-12s %7u  %9u %9u %9u\n", getResourceTypeName(type),
+			resMan->getCacheMemoryUsed(type) / 1024, resMan->getCacheBudget(type) / 1024,
+			resMan->getCacheHits(type), resMan->getCacheMisses(type));
+	}
+	if (hits + misses > 0)
+		DebugPrintf("Hit rate: %.1f%%\n", hits * 100 / (hits + misses));
+
+	return true;
+}
+
+bool Console::cmdViewCache(int argc, const char **argv) {
+	GfxCache *cache = _engine->_gfxCache;
+	if (!cache) {
+		DebugPrintf("The view cache is not in use\n");
+		return true;
+	}
+
+	const uint32 requests = cache->getViewCacheHits() + cache->getViewCacheMisses();
+	DebugPrintf("Cached views: %d, using %d of %d KB\n", cache->getViewCacheCount(),
+		cache->getViewCacheMemoryUsage() / 1024, cache->getViewCacheMemoryLimit() / 1024);
+	DebugPrintf("Requests: %u, hits: %u (%.1f%%), evictions: %u\n", requests, cache->getViewCacheHits(),
+		requests ? cache->getViewCacheHits() * 100.0 / requests : 0.0, cache->getViewCacheEvictions());
+	DebugPrintf("Cached pictures: %d, using %d KB, hits: %u, misses: %u\n", cache->getPictureCacheCount(),
+		cache->getPictureCacheMemoryUsage() / 1024, cache->getPictureCacheHits(), cache->getPictureCacheMisses());
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		DebugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -2233,7 +2284,9 @@ bool Console::cmdIsSample(int argc, const char **argv) {
 
 bool Console::cmdGCInvoke(int argc, const char **argv) {
 	DebugPrintf("Performing garbage collection...\n");
-	run_gc(_engine->_gamestate);
+	const uint32 startTime = g_system->getMillis();
+	const uint freed = run_gc(_engine->_gamestate);
+	DebugPrintf("Deallocated %u objects in %u ms\n", freed, g_system->getMillis() - startTime);
 	return true;
 }
 
@@ -2710,6 +2763,56 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		cache.resetStatistics();
+		DebugPrintf("Selector lookup cache statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		DebugPrintf("Shows the hit rate of the cache used for selector lookups in sends.\n");
+		DebugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	const uint32 lookups = cache.getHits() + cache.getMisses();
+	DebugPrintf("Selector lookups: %u, hits: %u, misses: %u (hit rate %.1f%%)\n",
+		lookups, cache.getHits(), cache.getMisses(), lookups ? cache.getHits() * 100.0 / lookups : 0.0);
+	DebugPrintf("Invalidations: %u\n", cache.getInvalidations());
+	return true;
+}
+
+bool Console::cmdProfiler(int argc, const char **argv) {
+	ScriptProfiler *profiler = _engine->_scriptProfiler;
+
+	if (argc >= 2 && !scumm_stricmp(argv[1], "on")) {
+		profiler->setEnabled(true);
+		DebugPrintf("Profiler enabled\n");
+	} else if (argc >= 2 && !scumm_stricmp(argv[1], "off")) {
+		profiler->setEnabled(false);
+		DebugPrintf("Profiler disabled\n");
+	} else if (argc >= 2 && !scumm_stricmp(argv[1], "reset")) {
+		profiler->reset();
+		DebugPrintf("Profiler data reset\n");
+	} else if (argc >= 2 && !scumm_stricmp(argv[1], "report")) {
+		profiler->printReport(this, argc >= 3 ? atoi(argv[2]) : 20);
+	} else if (argc == 3 && !scumm_stricmp(argv[1], "folded")) {
+		if (profiler->writeFoldedStacks(argv[2]))
+			DebugPrintf("Folded stacks written to %s\n", argv[2]);
+		else
+			DebugPrintf("Could not write %s\n", argv[2]);
+	} else {
+		DebugPrintf("Profiles kernel functions and scripts. Kernel functions are timed, scripts\n");
+		DebugPrintf("are sampled every few instructions.\n");
+		DebugPrintf("Usage: %s on|off|reset|report [<count>]|folded <file>\n", argv[0]);
+		DebugPrintf("The folded file has one execution stack per line, as used by flame graph tools.\n");
+		DebugPrintf("The profiler is currently %s.\n", profiler->isEnabled() ? "enabled" : "disabled");
+	}
+
+	return true;
+}
+
 bool Console::cmdBacktrace(int argc, const char **argv) {
 	DebugPrintf("Call stack (current base: 0x%x):\n", _engine->_gamestate->executionStackBase);
 	Common::List<ExecStack>::const_iterator iter;
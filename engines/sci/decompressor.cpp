@@ -53,11 +53,27 @@ void Decompressor::init(Common::ReadStream *src, byte *dest, uint32 nPacked,
 	_nBits = 0;
 	_dwRead = _dwWrote = 0;
 	_dwBits = 0;
+	_inPos = _inSize = _inRead = 0;
+}
+
+byte Decompressor::refillInput() {
+	if (_inRead >= _szPacked)
+		return _src->readByte();
+
+	_inSize = _src->read(_inBuffer, MIN<uint32>(kInputBufferSize, _szPacked - _inRead));
+	_inPos = 0;
+	_inRead += _inSize;
+	if (!_inSize) {
+		// Nothing left, make sure we do not try again
+		_inRead = _szPacked;
+		return 0;
+	}
+	return _inBuffer[_inPos++];
 }
 
 void Decompressor::fetchBitsMSB() {
 	while (_nBits <= 24) {
-		_dwBits |= ((uint32)_src->readByte()) << (24 - _nBits);
+		_dwBits |= ((uint32)readByte()) << (24 - _nBits);
 		_nBits += 8;
 		_dwRead++;
 	}
@@ -79,7 +95,7 @@ byte Decompressor::getByteMSB() {
 
 void Decompressor::fetchBitsLSB() {
 	while (_nBits <= 24) {
-		_dwBits |= ((uint32)_src->readByte()) << _nBits;
+		_dwBits |= ((uint32)readByte()) << _nBits;
 		_nBits += 8;
 		_dwRead++;
 	}
@@ -94,6 +94,17 @@ protected:
 	void fetchBitsMSB();
 	void fetchBitsLSB();
 
+	/**
+	 * Get the next byte of compressed data. The first _szPacked bytes are
+	 * read from _src in blocks, anything beyond that byte by byte.
+	 */
+	byte readByte() {
+		if (_inPos == _inSize)
+			return refillInput();
+		return _inBuffer[_inPos++];
+	}
+	byte refillInput();
+
 	/**
 	 * Write one byte into _dest stream
 	 * @param b byte to put
@@ -117,6 +128,12 @@ protected:
 	uint32 _dwWrote;	///< number of bytes written to _dest
 	Common::ReadStream *_src;
 	byte *_dest;
+
+	enum { kInputBufferSize = 1024 };
+	byte _inBuffer[kInputBufferSize];
+	uint32 _inPos;		///< read position in _inBuffer
+	uint32 _inSize;		///< number of valid bytes in _inBuffer
+	uint32 _inRead;		///< number of bytes read from _src into _inBuffer
 };
 
 /**
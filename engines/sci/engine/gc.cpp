@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 namespace Sci {
@@ -52,10 +53,12 @@ void WorklistManager::push(reg_t reg) {
 
 	debugC(kDebugLevelGC, "[GC] Adding %04x:%04x", PRINT_REG(reg));
 
-	if (_map.contains(reg))
+	// Look the address up only once, this is the hottest path of the GC
+	bool &known = _map[reg];
+	if (known)
 		return; // already dealt with it
 
-	_map.setVal(reg, true);
+	known = true;
 	_worklist.push_back(reg);
 }
 
@@ -160,8 +163,15 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
-void run_gc(EngineState *s) {
+uint run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
+	const uint32 startTime = g_system->getMillis();
+	uint freed = 0;
+
+	// A full collection is done now, so postpone the next periodic one. This
+	// keeps the VM from collecting again right after kFlushResources did on
+	// a room change.
+	s->gcCountDown = s->scriptGCInterval;
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
@@ -195,6 +205,7 @@ void run_gc(EngineState *s) {
 				if (!activeRefs->contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
+					freed++;
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
@@ -205,6 +216,9 @@ void run_gc(EngineState *s) {
 		}
 	}
 
+	debugC(kDebugLevelGC, "[GC] %d addresses in use, %d freed, took %d ms",
+		activeRefs->size(), freed, g_system->getMillis() - startTime);
+
 	delete activeRefs;
 
 #ifdef GC_DEBUG_CODE
@@ -214,6 +228,8 @@ void run_gc(EngineState *s) {
 		if (segcount[i])
 			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
 #endif
+
+	return freed;
 }
 
 } // End of namespace Sci
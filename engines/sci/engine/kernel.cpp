@@ -929,12 +929,80 @@ Common::String Kernel::lookupText(reg_t address, int index) {
 	return NULL;
 }
 
+/**
+ * Derives the operand layout of all 256 extended opcodes from the current
+ * opcode formats. Must be called whenever _opcode_formats changes.
+ */
+static void buildOpcodeLayouts() {
+	if (!g_sci->_opcodeLayouts)
+		g_sci->_opcodeLayouts = new PMachineOpcodeLayout[256];
+
+	for (int extOpcode = 0; extOpcode < 256; ++extOpcode) {
+		const byte opcode = extOpcode >> 1;
+		const bool isByteSized = (extOpcode & 1) != 0;
+		PMachineOpcodeLayout &layout = g_sci->_opcodeLayouts[extOpcode];
+		memset(&layout, 0, sizeof(layout));
+
+		for (int i = 0; g_sci->_opcode_formats[opcode][i]; ++i) {
+			assert(i < 3);
+			layout.numOperands = i + 1;
+			switch (g_sci->_opcode_formats[opcode][i]) {
+			case Script_Byte:
+				layout.operandSize[i] = 1;
+				break;
+			case Script_SByte:
+				layout.operandSize[i] = 1;
+				layout.operandSigned[i] = true;
+				break;
+			case Script_Word:
+				layout.operandSize[i] = 2;
+				break;
+			case Script_SWord:
+				layout.operandSize[i] = 2;
+				layout.operandSigned[i] = true;
+				break;
+			case Script_Variable:
+			case Script_Property:
+			case Script_Local:
+			case Script_Temp:
+			case Script_Global:
+			case Script_Param:
+			case Script_Offset:
+				layout.operandSize[i] = isByteSized ? 1 : 2;
+				break;
+			case Script_SVariable:
+			case Script_SRelative:
+				layout.operandSize[i] = isByteSized ? 1 : 2;
+				layout.operandSigned[i] = true;
+				break;
+			case Script_None:
+			case Script_End:
+				break;
+			case Script_Invalid:
+			default:
+				layout.invalid = true;
+				break;
+			}
+			if (layout.invalid)
+				break;
+		}
+
+		// op_pushSelf with the low bit set is the debug opcode op_file, which
+		// is followed by a file name. Non-Sierra compilers generate pushSelf
+		// with the low bit set, though (see readPMachineInstruction()).
+		if (opcode == op_pushSelf && isByteSized && g_sci->getGameId() != GID_FANMADE)
+			layout.skipString = true;
+	}
+}
+
 // TODO: script_adjust_opcode_formats should probably be part of the
 // constructor (?) of a VirtualMachine or a ScriptManager class.
 void script_adjust_opcode_formats() {
 
 	g_sci->_opcode_formats = new opcode_format[128][4];
 	memcpy(g_sci->_opcode_formats, g_base_opcode_formats, 128*4*sizeof(opcode_format));
+	// detectLofsType() below already decodes instructions
+	buildOpcodeLayouts();
 
 	if (g_sci->_features->detectLofsType() != SCI_VERSION_0_EARLY) {
 		g_sci->_opcode_formats[op_lofsa][0] = Script_Offset;
@@ -960,6 +1028,8 @@ void script_adjust_opcode_formats() {
 		g_sci->_opcode_formats[0x4e/2][0] = Script_None;
 	}
 #endif
+
+	buildOpcodeLayouts();
 }
 
 } // End of namespace Sci
@@ -108,12 +108,18 @@ struct Vertex {
 	uint32 costF;
 	uint32 costG;
 
+	// A* set membership, replaces searching the open and closed sets
+	bool isOpen;
+	bool isClosed;
+
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
+		isOpen = false;
+		isClosed = false;
 		path_prev = NULL;
 	}
 };
@@ -675,11 +681,23 @@ static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
 			continue;
 
+		// Bounding box of the line of sight. Edges entirely outside of it
+		// can neither touch nor properly intersect it.
+		const int16 minX = MIN(vertex_cur->v.x, vertex->v.x);
+		const int16 maxX = MAX(vertex_cur->v.x, vertex->v.x);
+		const int16 minY = MIN(vertex_cur->v.y, vertex->v.y);
+		const int16 maxY = MAX(vertex_cur->v.y, vertex->v.y);
+
 		// Check for intersecting edges
 		int j;
 		for (j = 0; j < s->vertices; j++) {
 			Vertex *edge = s->vertex_index[j];
 			if (VERTEX_HAS_EDGES(edge)) {
+				const Common::Point &edgeEnd = CLIST_NEXT(edge)->v;
+				if ((edge->v.x < minX && edgeEnd.x < minX) || (edge->v.x > maxX && edgeEnd.x > maxX) ||
+					(edge->v.y < minY && edgeEnd.y < minY) || (edge->v.y > maxY && edgeEnd.y > maxY))
+					continue;
+
 				if (between(vertex_cur->v, vertex->v, edge->v)) {
 					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
 					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
@@ -689,7 +707,7 @@ static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 					continue;
 				}
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, edgeEnd))
 					break;
 			}
 		}
@@ -1310,13 +1328,20 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
  * Parameters: (PathfindingState *) s: The pathfinding state
  */
 static void AStar(PathfindingState *s) {
-	// Vertices of which the shortest path is known
-	VertexList closedSet;
-
-	// The remaining vertices
+	// The remaining vertices. Vertices of which the shortest path is known
+	// have isClosed set instead of being kept in a closed set.
 	VertexList openSet;
 
 	openSet.push_front(s->vertex_start);
+	s->vertex_start->isOpen = true;
+
+	// WORKAROUND: The screen edge penalty below fails in QFG1VGA, room 81 (bug
+	// report #3568452). However, it is needed in other SCI1.1 games, such as
+	// LB2. Therefore, we add this workaround for that scene in QFG1VGA, until
+	// our algorithm matches better what SSCI is doing. With this workaround,
+	// QFG1VGA no longer freezes in that scene.
+	const bool qfg1VgaWorkaround = (g_sci->getGameId() == GID_QFG1VGA &&
+									g_sci->getEngineState()->currentRoomNumber() == 81);
 	s->vertex_start->costG = 0;
 	s->vertex_start->costF = (uint32)sqrt((float)s->vertex_start->v.sqrDist(s->vertex_end->v));
 
@@ -1342,7 +1367,8 @@ static void AStar(PathfindingState *s) {
 			break;
 
 		// Move vertex from set open to set closed
-		closedSet.push_front(vertex_min);
+		vertex_min->isOpen = false;
+		vertex_min->isClosed = true;
 		openSet.erase(vertex_min_it);
 
 		VertexList *visVerts = visible_vertices(s, vertex_min);
@@ -1351,11 +1377,13 @@ static void AStar(PathfindingState *s) {
 			uint32 new_dist;
 			Vertex *vertex = *it;
 
-			if (closedSet.contains(vertex))
+			if (vertex->isClosed)
 				continue;
 
-			if (!openSet.contains(vertex))
+			if (!vertex->isOpen) {
 				openSet.push_front(vertex);
+				vertex->isOpen = true;
+			}
 
 			new_dist = vertex_min->costG + (uint32)sqrt((float)vertex_min->v.sqrDist(vertex->v));
 
@@ -1367,14 +1395,7 @@ static void AStar(PathfindingState *s) {
 			// This difference might lead to problems, but none are
 			// known at the time of writing.
 
-			// WORKAROUND: This check fails in QFG1VGA, room 81 (bug report #3568452).
-			// However, it is needed in other SCI1.1 games, such as LB2. Therefore, we
-			// add this workaround for that scene in QFG1VGA, until our algorithm matches
-			// better what SSCI is doing. With this workaround, QFG1VGA no longer freezes
-			// in that scene.
-			bool qfg1VgaWorkaround = (g_sci->getGameId() == GID_QFG1VGA &&
-									  g_sci->getEngineState()->currentRoomNumber() == 81);
-
+			// The penalty is not applied in QFG1VGA, room 81, see qfg1VgaWorkaround
 			if (s->pointOnScreenBorder(vertex->v) && !qfg1VgaWorkaround)
 				new_dist += 10000;
 
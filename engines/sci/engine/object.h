@@ -231,6 +231,7 @@ public:
 	void initSuperClass(SegManager *segMan, reg_t addr);
 	bool initBaseObject(SegManager *segMan, reg_t addr, bool doInitSuperClass = true);
 	void syncBaseObject(const byte *ptr) { _baseObj = ptr; }
+	const byte *getBaseObject() const { return _baseObj; }
 
 private:
 	void initSelectorsSci3(const byte *buf);
@@ -0,0 +1,181 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/algorithm.h"
+#include "common/file.h"
+
+#include "sci/sci.h"
+#include "sci/console.h"
+#include "sci/engine/kernel.h"
+#include "sci/engine/profiler.h"
+#include "sci/engine/script.h"
+#include "sci/engine/seg_manager.h"
+#include "sci/engine/state.h"
+
+namespace Sci {
+
+ScriptProfiler::ScriptProfiler() : _enabled(false) {
+	reset();
+}
+
+void ScriptProfiler::reset() {
+	_instructionsSinceSample = 0;
+	_totalSamples = 0;
+	_kernelCalls.clear();
+	_methodSamples.clear();
+	_stackSamples.clear();
+	_rooms.clear();
+}
+
+void ScriptProfiler::countKernelCall(EngineState *s, uint kernelCallNr, uint32 millis) {
+	const KernelEntry empty = { 0, 0 };
+	while (kernelCallNr >= _kernelCalls.size())
+		_kernelCalls.push_back(empty);
+	_kernelCalls[kernelCallNr].calls++;
+	_kernelCalls[kernelCallNr].millis += millis;
+
+	RoomEntry &room = _rooms[s->currentRoomNumber()];
+	room.kernelCalls++;
+	room.kernelMillis += millis;
+}
+
+Common::String ScriptProfiler::getFrameName(EngineState *s, const ExecStack &frame) const {
+	Kernel *kernel = g_sci->getKernel();
+
+	if (frame.type == EXEC_STACK_TYPE_KERNEL)
+		return "k" + kernel->getKernelName(frame.debugSelector);
+
+	const Script *script = s->_segMan->getScriptIfLoaded(frame.addr.pc.getSegment());
+	const int scriptNr = script ? script->getScriptNumber() : -1;
+
+	if (frame.debugSelector != -1)
+		return Common::String::format("%s::%s", s->_segMan->getObjectName(frame.sendp),
+		                              kernel->getSelectorName(frame.debugSelector).c_str());
+	if (frame.debugExportId != -1)
+		return Common::String::format("script %d export %d", scriptNr, frame.debugExportId);
+	return Common::String::format("script %d call %x", scriptNr, frame.debugLocalCallOffset);
+}
+
+void ScriptProfiler::takeSample(EngineState *s) {
+	_instructionsSinceSample = 0;
+	_totalSamples++;
+
+	Common::String stack;
+	Common::String method;
+	Common::List<ExecStack>::const_iterator it;
+	for (it = s->_executionStack.begin(); it != s->_executionStack.end(); ++it) {
+		if (it->type == EXEC_STACK_TYPE_VARSELECTOR)
+			continue;
+		method = getFrameName(s, *it);
+		if (!stack.empty())
+			stack += ';';
+		stack += method;
+	}
+
+	_methodSamples[method]++;
+	_stackSamples[stack]++;
+	_rooms[s->currentRoomNumber()].samples++;
+}
+
+namespace {
+
+struct ReportLine {
+	Common::String name;
+	uint32 value;
+	uint32 extra;
+};
+
+struct ReportLineGreater {
+	bool operator()(const ReportLine &a, const ReportLine &b) const {
+		return a.value > b.value;
+	}
+};
+
+void printSection(Console *con, const char *title, Common::Array<ReportLine> &lines, uint maxEntries, uint32 total, const char *extraFormat) {
+	Common::sort(lines.begin(), lines.end(), ReportLineGreater());
+
+	con->DebugPrintf("%s:\n", title);
+	for (uint i = 0; i < lines.size() && i < maxEntries; i++) {
+		const ReportLine &line = lines[i];
+		con->DebugPrintf(" %6.1f%% %8u", total ? line.value * 100.0 / total : 0.0, line.value);
+		if (extraFormat)
+			con->DebugPrintf(extraFormat, line.extra);
+		con->DebugPrintf("  %s\n", line.name.c_str());
+	}
+	if (lines.size() > maxEntries)
+		con->DebugPrintf(" ... %u more\n", lines.size() - maxEntries);
+	con->DebugPrintf("\n");
+}
+
+} // End of anonymous namespace
+
+void ScriptProfiler::printReport(Console *con, uint maxEntries) const {
+	Kernel *kernel = g_sci->getKernel();
+	Common::Array<ReportLine> lines;
+	ReportLine line;
+
+	uint32 totalMillis = 0;
+	for (uint i = 0; i < _kernelCalls.size(); i++) {
+		if (!_kernelCalls[i].calls)
+			continue;
+		line.name = "k" + kernel->getKernelName(i);
+		line.value = _kernelCalls[i].millis;
+		line.extra = _kernelCalls[i].calls;
+		lines.push_back(line);
+		totalMillis += line.value;
+	}
+	printSection(con, "Kernel functions (ms, calls)", lines, maxEntries, totalMillis, " %8u");
+
+	lines.clear();
+	for (SampleMap::const_iterator it = _methodSamples.begin(); it != _methodSamples.end(); ++it) {
+		line.name = it->_key;
+		line.value = it->_value;
+		line.extra = 0;
+		lines.push_back(line);
+	}
+	printSection(con, "Script methods (samples)", lines, maxEntries, _totalSamples, 0);
+
+	lines.clear();
+	for (RoomMap::const_iterator it = _rooms.begin(); it != _rooms.end(); ++it) {
+		line.name = Common::String::format("room %d", it->_key);
+		line.value = it->_value.samples;
+		line.extra = it->_value.kernelMillis;
+		lines.push_back(line);
+	}
+	printSection(con, "Rooms (samples, kernel ms)", lines, maxEntries, _totalSamples, " %8u");
+
+	con->DebugPrintf("%u samples, one every %d instructions\n", _totalSamples, kSampleInterval);
+}
+
+bool ScriptProfiler::writeFoldedStacks(const Common::String &filename) const {
+	Common::DumpFile file;
+	if (!file.open(filename))
+		return false;
+
+	for (SampleMap::const_iterator it = _stackSamples.begin(); it != _stackSamples.end(); ++it)
+		file.writeString(Common::String::format("%s %u\n", it->_key.c_str(), it->_value));
+
+	file.finalize();
+	return !file.err();
+}
+
+} // End of namespace Sci
@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_PROFILER_H
+#define SCI_ENGINE_PROFILER_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+namespace Sci {
+
+class Console;
+struct EngineState;
+struct ExecStack;
+
+/**
+ * Profiler for scripts and kernel functions, enabled with the "profiler"
+ * console command.
+ *
+ * Kernel functions are timed on every call; their time includes scripts
+ * they call back into. Scripts are sampled every kSampleInterval executed
+ * instructions: a sample is counted for the method on top of the execution
+ * stack, for the current room and for the whole execution stack, which can
+ * be written out as folded stacks for flame graph tools.
+ */
+class ScriptProfiler {
+public:
+	ScriptProfiler();
+
+	bool isEnabled() const { return _enabled; }
+	void setEnabled(bool enabled) { _enabled = enabled; }
+	void reset();
+
+	/** Called for every executed instruction while enabled. */
+	void countInstruction(EngineState *s) {
+		if (++_instructionsSinceSample >= kSampleInterval)
+			takeSample(s);
+	}
+
+	/** Called after each kernel call while enabled. */
+	void countKernelCall(EngineState *s, uint kernelCallNr, uint32 millis);
+
+	void printReport(Console *con, uint maxEntries) const;
+	bool writeFoldedStacks(const Common::String &filename) const;
+
+private:
+	enum {
+		kSampleInterval = 100 ///< Instructions per script sample
+	};
+
+	struct KernelEntry {
+		uint32 calls;
+		uint32 millis;
+	};
+
+	struct RoomEntry {
+		uint32 samples;
+		uint32 kernelCalls;
+		uint32 kernelMillis;
+	};
+
+	typedef Common::HashMap<Common::String, uint32> SampleMap;
+	typedef Common::HashMap<int, RoomEntry> RoomMap;
+
+	void takeSample(EngineState *s);
+	Common::String getFrameName(EngineState *s, const ExecStack &frame) const;
+
+	bool _enabled;
+	uint32 _instructionsSinceSample;
+	uint32 _totalSamples;
+
+	Common::Array<KernelEntry> _kernelCalls;
+	SampleMap _methodSamples;
+	SampleMap _stackSamples;
+	RoomMap _rooms;
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_PROFILER_H
@@ -78,6 +78,8 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	_selectorLookupCache.invalidate();
 }
 
 void SegManager::initSysStrings() {
@@ -156,6 +158,8 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+		// Cached lookups may point into this script
+		_selectorLookupCache.invalidate();
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -977,6 +981,10 @@ int SegManager::instantiateScript(int scriptNum) {
 		scr = allocateScript(scriptNum, &segmentId);
 	}
 
+	// Objects of the new script may be placed where objects of freed
+	// scripts used to be
+	_selectorLookupCache.invalidate();
+
 	scr->load(scriptNum, _resMan);
 	scr->initializeLocals(this);
 	scr->initializeClasses(this);
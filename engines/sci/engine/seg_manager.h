@@ -441,7 +441,11 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/** Cache for selector lookups done by send_selector(). */
+	SelectorLookupCache &getSelectorLookupCache() { return _selectorLookupCache; }
+
 private:
+	SelectorLookupCache _selectorLookupCache;
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
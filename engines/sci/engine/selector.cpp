@@ -295,4 +295,59 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 //	return _lookupSelector_function(segMan, obj, selectorId, fptr);
 }
 
+SelectorLookupCache::SelectorLookupCache() {
+	invalidate();
+	resetStatistics();
+}
+
+SelectorType SelectorLookupCache::lookup(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
+	const Object *obj = segMan->getObject(obj_location);
+	if (!obj || !obj->getBaseObject())
+		return lookupSelector(segMan, obj_location, selectorId, varp, fptr);
+
+	const byte *baseObj = obj->getBaseObject();
+	const uint hash = (uint)(((size_t)baseObj >> 1) ^ ((uint16)selectorId * 0x9E5));
+	Entry &entry = _entries[hash & (kCacheSize - 1)];
+
+	if (entry.baseObj == baseObj && entry.selector == selectorId) {
+		_hits++;
+	} else {
+		_misses++;
+		ObjVarRef var;
+		reg_t funcp = NULL_REG;
+		var.varindex = -1;
+		const SelectorType type = lookupSelector(segMan, obj_location, selectorId, &var, &funcp);
+		if (type == kSelectorNone)
+			return kSelectorNone;
+
+		entry.baseObj = baseObj;
+		entry.selector = selectorId;
+		entry.type = type;
+		entry.varIndex = var.varindex;
+		entry.funcp = funcp;
+	}
+
+	if (entry.type == kSelectorVariable) {
+		if (varp) {
+			varp->obj = obj_location;
+			varp->varindex = entry.varIndex;
+		}
+	} else if (fptr) {
+		*fptr = entry.funcp;
+	}
+
+	return entry.type;
+}
+
+void SelectorLookupCache::invalidate() {
+	memset(_entries, 0, sizeof(_entries));
+	_invalidations++;
+}
+
+void SelectorLookupCache::resetStatistics() {
+	_hits = 0;
+	_misses = 0;
+	_invalidations = 0;
+}
+
 } // End of namespace Sci
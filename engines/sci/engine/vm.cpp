@@ -21,6 +21,7 @@
  */
 
 #include "common/debug.h"
+#include "common/system.h"
 #include "common/debug-channels.h"
 
 #include "sci/sci.h"
@@ -34,6 +35,7 @@
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/selector.h"	// for SELECTOR
 #include "sci/engine/gc.h"
+#include "sci/engine/profiler.h"
 #include "sci/engine/workarounds.h"
 
 namespace Sci {
@@ -283,7 +285,7 @@ ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj, StackPt
 		if (argc > 0x800)	// More arguments than the stack could possibly accomodate for
 			error("send_selector(): More than 0x800 arguments to function call");
 
-		SelectorType selectorType = lookupSelector(s->_segMan, send_obj, selector, &varp, &funcp);
+		SelectorType selectorType = s->_segMan->getSelectorLookupCache().lookup(s->_segMan, send_obj, selector, &varp, &funcp);
 		if (selectorType == kSelectorNone)
 			error("Send to invalid selector 0x%x of object at %04x:%04x", 0xffff & selector, PRINT_REG(send_obj));
 
@@ -369,6 +371,8 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 		}
 	}
 
+	ScriptProfiler *profiler = g_sci->_scriptProfiler;
+	const uint32 profileStart = profiler->isEnabled() ? g_system->getMillis() : 0;
 
 	// Call kernel function
 	if (!kernelCall.subFunctionCount) {
@@ -439,6 +443,9 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 		}
 	}
 
+	if (profiler->isEnabled())
+		profiler->countKernelCall(s, kernelCallNr, g_system->getMillis() - profileStart);
+
 	// Remove callk stack frame again, if there's still an execution stack
 	if (s->_executionStack.begin() != s->_executionStack.end())
 		s->_executionStack.pop_back();
@@ -447,82 +454,42 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4]) {
 	uint offset = 0;
 	extOpcode = src[offset++]; // Get "extended" opcode (lower bit has special meaning)
-	const byte opcode = extOpcode >> 1;	// get the actual opcode
-
-	memset(opparams, 0, 4*sizeof(int16));
-
-	for (int i = 0; g_sci->_opcode_formats[opcode][i]; ++i) {
-		//debugN("Opcode: 0x%x, Opnumber: 0x%x, temp: %d\n", opcode, opcode, temp);
-		assert(i < 3);
-		switch (g_sci->_opcode_formats[opcode][i]) {
 
-		case Script_Byte:
-			opparams[i] = src[offset++];
-			break;
-		case Script_SByte:
-			opparams[i] = (int8)src[offset++];
-			break;
+	// The operand layout of every extended opcode is derived from
+	// _opcode_formats once, see buildOpcodeLayouts() in kernel.cpp
+	const PMachineOpcodeLayout &layout = g_sci->_opcodeLayouts[extOpcode];
+	if (layout.invalid)
+		error("opcode %02x: Invalid", extOpcode);
 
-		case Script_Word:
-			opparams[i] = READ_SCI11ENDIAN_UINT16(src + offset);
-			offset += 2;
+	int i = 0;
+	for (; i < layout.numOperands; ++i) {
+		switch (layout.operandSize[i]) {
+		case 1:
+			opparams[i] = layout.operandSigned[i] ? (int8)src[offset] : src[offset];
+			offset++;
 			break;
-		case Script_SWord:
+		case 2:
 			opparams[i] = (int16)READ_SCI11ENDIAN_UINT16(src + offset);
 			offset += 2;
 			break;
-
-		case Script_Variable:
-		case Script_Property:
-
-		case Script_Local:
-		case Script_Temp:
-		case Script_Global:
-		case Script_Param:
-
-		case Script_Offset:
-			if (extOpcode & 1) {
-				opparams[i] = src[offset++];
-			} else {
-				opparams[i] = READ_SCI11ENDIAN_UINT16(src + offset);
-				offset += 2;
-			}
-			break;
-
-		case Script_SVariable:
-		case Script_SRelative:
-			if (extOpcode & 1) {
-				opparams[i] = (int8)src[offset++];
-			} else {
-				opparams[i] = (int16)READ_SCI11ENDIAN_UINT16(src + offset);
-				offset += 2;
-			}
-			break;
-
-		case Script_None:
-		case Script_End:
-			break;
-
-		case Script_Invalid:
 		default:
-			error("opcode %02x: Invalid", extOpcode);
+			opparams[i] = 0;
+			break;
 		}
 	}
+	for (; i < 4; ++i)
+		opparams[i] = 0;
 
 	// Special handling of the op_line opcode
-	if (opcode == op_pushSelf) {
-		// Compensate for a bug in non-Sierra compilers, which seem to generate
-		// pushSelf instructions with the low bit set. This makes the following
-		// heuristic fail and leads to endless loops and crashes. Our
-		// interpretation of this seems correct, as other SCI tools, like for
-		// example SCI Viewer, have issues with these scripts (e.g. script 999
-		// in Circus Quest). Fixes bug #3038686.
-		if (!(extOpcode & 1) || g_sci->getGameId() == GID_FANMADE) {
-			// op_pushSelf: no adjustment necessary
-		} else {
-			// Debug opcode op_file, skip null-terminated string (file name)
-			while (src[offset++]) {}
-		}
+	if (layout.skipString) {
+		// Debug opcode op_file, skip null-terminated string (file name).
+		// Non-Sierra compilers seem to generate pushSelf instructions with
+		// the low bit set, so this is not done for fan made games, where
+		// it leads to endless loops and crashes. Our interpretation of this
+		// seems correct, as other SCI tools, like for example SCI Viewer,
+		// have issues with these scripts (e.g. script 999 in Circus Quest).
+		// Fixes bug #3038686.
+		while (src[offset++]) {}
 	}
 
 	return offset;
@@ -535,6 +502,7 @@ void run_vm(EngineState *s) {
 	reg_t r_temp; // Temporary register
 	StackPtr s_temp; // Temporary stack pointer
 	int16 opparams[4]; // opcode parameters
+	ScriptProfiler *profiler = g_sci->_scriptProfiler;
 
 	s->r_rest = 0;	// &rest adjusts the parameter count by this value
 	// Current execution data:
@@ -839,10 +807,8 @@ void run_vm(EngineState *s) {
 
 		case op_callk: { // 0x21 (33)
 			// Run the garbage collector, if needed
-			if (s->gcCountDown-- <= 0) {
-				s->gcCountDown = s->scriptGCInterval;
+			if (s->gcCountDown-- <= 0)
 				run_gc(s);
-			}
 
 			// Call kernel function
 			s->xs->sp -= (opparams[1] >> 1) + 1;
@@ -1330,6 +1296,8 @@ void run_vm(EngineState *s) {
 					opcode);
 		}
 		++s->scriptStepCounter;
+		if (profiler->isEnabled())
+			profiler->countInstruction(s);
 	}
 }
 
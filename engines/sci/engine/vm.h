@@ -348,6 +348,49 @@ void script_debug(EngineState *s);
 SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
 		ObjVarRef *varp, reg_t *fptr);
 
+/**
+ * Direct mapped cache of lookupSelector() results, used by send_selector().
+ * Entries are keyed on the selector and on the object's definition in its
+ * script, which clones share with the object they were cloned from. The
+ * cache has to be invalidated whenever scripts are loaded or unloaded.
+ */
+class SelectorLookupCache {
+public:
+	SelectorLookupCache();
+
+	/** Same as lookupSelector(), but consults the cache first. */
+	SelectorType lookup(SegManager *segMan, reg_t obj, Selector selectorId,
+		ObjVarRef *varp, reg_t *fptr);
+
+	/** Drops all cached lookups. */
+	void invalidate();
+
+	/** Resets the hit, miss and invalidation counters. */
+	void resetStatistics();
+
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint32 getInvalidations() const { return _invalidations; }
+
+private:
+	enum {
+		kCacheSize = 1024 ///< Number of entries, must be a power of two
+	};
+
+	struct Entry {
+		const byte *baseObj;
+		Selector selector;
+		SelectorType type;
+		int varIndex;
+		reg_t funcp;
+	};
+
+	Entry _entries[kCacheSize];
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _invalidations;
+};
+
 /**
  * Read a PMachine instruction from a memory buffer and return its length.
  *
@@ -256,6 +256,19 @@ enum opcode_format {
 	Script_End
 };
 
+/**
+ * Operand layout of one "extended" opcode (opcode plus size bit), derived
+ * from the opcode formats once, so that instructions can be decoded without
+ * interpreting the formats on every step.
+ */
+struct PMachineOpcodeLayout {
+	byte numOperands;		///< number of opparams slots in use
+	byte operandSize[3];	///< size in bytes of each operand (0 for Script_None)
+	bool operandSigned[3];	///< whether each operand is sign extended
+	bool skipString;		///< op_file: a null-terminated file name follows
+	bool invalid;			///< one of the formats is Script_Invalid
+};
+
 
 } // End of namespace Sci
 
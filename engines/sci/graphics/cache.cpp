@@ -35,12 +35,17 @@
 namespace Sci {
 
 GfxCache::GfxCache(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette)
-	: _resMan(resMan), _screen(screen), _palette(palette) {
+	: _resMan(resMan), _screen(screen), _palette(palette), _viewAccessCounter(0),
+	_viewCacheHits(0), _viewCacheMisses(0), _viewCacheEvictions(0),
+	_pictureAccessCounter(0), _pictureCacheHits(0), _pictureCacheMisses(0) {
+	// SCI32 cels are hires and considerably bigger
+	_maxViewMemory = (getSciVersion() >= SCI_VERSION_2) ? MAX_CACHED_VIEW_MEMORY_SCI32 : MAX_CACHED_VIEW_MEMORY;
 }
 
 GfxCache::~GfxCache() {
 	purgeFontCache();
 	purgeViewCache();
+	purgePictureCache();
 }
 
 void GfxCache::purgeFontCache() {
@@ -54,13 +59,109 @@ void GfxCache::purgeFontCache() {
 
 void GfxCache::purgeViewCache() {
 	for (ViewCache::iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter) {
-		delete iter->_value;
-		iter->_value = 0;
+		delete iter->_value.view;
+		iter->_value.view = 0;
 	}
 
 	_cachedViews.clear();
 }
 
+void GfxCache::purgePictureCache() {
+	for (PictureCache::iterator iter = _cachedPictures.begin(); iter != _cachedPictures.end(); ++iter) {
+		delete[] (*iter)->bitsBefore;
+		delete[] (*iter)->bitsAfter;
+		delete *iter;
+	}
+
+	_cachedPictures.clear();
+}
+
+uint32 GfxCache::getViewCacheMemoryUsage() const {
+	uint32 size = 0;
+	for (ViewCache::const_iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter)
+		size += iter->_value.view->getMemoryUsage();
+	return size;
+}
+
+/**
+ * Evicts the least recently used views until there is room for another one.
+ * The most recently requested view is kept, as callers may still use it.
+ */
+void GfxCache::evictViews() {
+	uint32 memoryUsage = getViewCacheMemoryUsage();
+
+	while (_cachedViews.size() > 1 && (_cachedViews.size() >= MAX_CACHED_VIEWS || memoryUsage > _maxViewMemory)) {
+		ViewCache::iterator oldest = _cachedViews.end();
+		for (ViewCache::iterator iter = _cachedViews.begin(); iter != _cachedViews.end(); ++iter) {
+			if (iter->_value.lastUsed == _viewAccessCounter)
+				continue;
+			if (oldest == _cachedViews.end() || iter->_value.lastUsed < oldest->_value.lastUsed)
+				oldest = iter;
+		}
+
+		memoryUsage -= oldest->_value.view->getMemoryUsage();
+		delete oldest->_value.view;
+		_cachedViews.erase(oldest);
+		_viewCacheEvictions++;
+	}
+}
+
+uint32 GfxCache::getPictureCacheMemoryUsage() const {
+	uint32 size = 0;
+	for (PictureCache::const_iterator iter = _cachedPictures.begin(); iter != _cachedPictures.end(); ++iter)
+		size += (*iter)->getMemoryUsage();
+	return size;
+}
+
+/**
+ * Evicts the least recently used pictures until there is room for another
+ * one, which needs the given amount of memory.
+ */
+void GfxCache::evictPictures(uint32 neededMemory) {
+	uint32 memoryUsage = getPictureCacheMemoryUsage();
+
+	while (!_cachedPictures.empty() && (_cachedPictures.size() >= MAX_CACHED_PICTURES || memoryUsage + neededMemory > MAX_CACHED_PICTURE_MEMORY)) {
+		PictureCache::iterator oldest = _cachedPictures.begin();
+		for (PictureCache::iterator iter = _cachedPictures.begin(); iter != _cachedPictures.end(); ++iter) {
+			if ((*iter)->lastUsed < (*oldest)->lastUsed)
+				oldest = iter;
+		}
+
+		memoryUsage -= (*oldest)->getMemoryUsage();
+		delete[] (*oldest)->bitsBefore;
+		delete[] (*oldest)->bitsAfter;
+		delete *oldest;
+		_cachedPictures.erase(oldest);
+	}
+}
+
+const CachedPicture *GfxCache::findPicture(const CachedPicture &key, const byte *bitsBefore) {
+	for (PictureCache::iterator iter = _cachedPictures.begin(); iter != _cachedPictures.end(); ++iter) {
+		CachedPicture *picture = *iter;
+		if (picture->pictureId != key.pictureId || picture->mirrored != key.mirrored
+			|| picture->EGApaletteNo != key.EGApaletteNo || picture->undithering != key.undithering
+			|| picture->portTop != key.portTop || picture->portLeft != key.portLeft
+			|| picture->portRect != key.portRect || picture->bitsSize != key.bitsSize)
+			continue;
+		if (memcmp(picture->bitsBefore, bitsBefore, picture->bitsSize))
+			continue;
+
+		_pictureCacheHits++;
+		picture->lastUsed = ++_pictureAccessCounter;
+		return picture;
+	}
+
+	_pictureCacheMisses++;
+	return 0;
+}
+
+void GfxCache::addPicture(CachedPicture *picture) {
+	evictPictures(picture->getMemoryUsage());
+
+	picture->lastUsed = ++_pictureAccessCounter;
+	_cachedPictures.push_back(picture);
+}
+
 GfxFont *GfxCache::getFont(GuiResourceId fontId) {
 	if (_cachedFonts.size() >= MAX_CACHED_FONTS)
 		purgeFontCache();
@@ -77,13 +178,20 @@ GfxFont *GfxCache::getFont(GuiResourceId fontId) {
 }
 
 GfxView *GfxCache::getView(GuiResourceId viewId) {
-	if (_cachedViews.size() >= MAX_CACHED_VIEWS)
-		purgeViewCache();
+	ViewCache::iterator iter = _cachedViews.find(viewId);
+	if (iter != _cachedViews.end()) {
+		_viewCacheHits++;
+		iter->_value.lastUsed = ++_viewAccessCounter;
+		return iter->_value.view;
+	}
 
-	if (!_cachedViews.contains(viewId))
-		_cachedViews[viewId] = new GfxView(_resMan, _screen, _palette, viewId);
+	_viewCacheMisses++;
+	evictViews();
 
-	return _cachedViews[viewId];
+	CachedView &cachedView = _cachedViews[viewId];
+	cachedView.view = new GfxView(_resMan, _screen, _palette, viewId);
+	cachedView.lastUsed = ++_viewAccessCounter;
+	return cachedView.view;
 }
 
 int16 GfxCache::kernelViewGetCelWidth(GuiResourceId viewId, int16 loopNo, int16 celNo) {
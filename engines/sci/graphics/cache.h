@@ -23,18 +23,77 @@
 #ifndef SCI_GRAPHICS_CACHE_H
 #define SCI_GRAPHICS_CACHE_H
 
+#include "common/array.h"
 #include "common/hashmap.h"
+#include "common/list.h"
+
+#include "sci/graphics/helpers.h"
 
 namespace Sci {
 
 class GfxFont;
 class GfxView;
 
+struct CachedView {
+	GfxView *view;
+	uint32 lastUsed; ///< value of the access counter when last requested
+};
+
+enum PictureStateChangeType {
+	kPictureSetPalette,
+	kPictureModifyAmigaPalette,
+	kPicturePriorityTable,
+	kPicturePriorityBands
+};
+
+/**
+ * A change of the palette or of the priority bands made while drawing a
+ * picture. These are not part of the screen planes, so they are repeated
+ * when a cached picture is restored.
+ */
+struct PictureStateChange {
+	PictureStateChangeType type;
+	Palette palette;	///< kPictureSetPalette
+	byte data[32];	///< kPictureModifyAmigaPalette and kPicturePriorityTable
+	int16 top, bottom;	///< kPicturePriorityBands
+};
+
+/**
+ * The screen planes around drawing a vector picture. Drawing the picture
+ * with the same parameters onto the same planes always gives the same
+ * result, so it can be replaced by restoring the planes afterwards.
+ */
+struct CachedPicture {
+	GuiResourceId pictureId;
+	bool mirrored;
+	int16 EGApaletteNo;
+	int16 portTop, portLeft;
+	Common::Rect portRect;
+	bool undithering;
+
+	uint32 bitsSize;
+	byte *bitsBefore;	///< GfxScreen::bitsSave() of the whole screen before drawing
+	byte *bitsAfter;	///< GfxScreen::bitsSave() of the whole screen after drawing
+	Common::Array<PictureStateChange> stateChanges;
+	Common::Array<int16> ditheredPicColors;	///< only when undithering
+
+	uint32 lastUsed;
+
+	uint32 getMemoryUsage() const {
+		return bitsSize * 2 + stateChanges.size() * sizeof(PictureStateChange);
+	}
+};
+
 typedef Common::HashMap<int, GfxFont *> FontCache;
-typedef Common::HashMap<int, GfxView *> ViewCache;
+typedef Common::HashMap<int, CachedView> ViewCache;
+typedef Common::List<CachedPicture *> PictureCache;
 
 /**
- * Cache class, handles caching of views/fonts
+ * Cache class, handles caching of views/fonts/pictures
+ *
+ * Views keep their decoded cels, so they are evicted least recently used
+ * first once either their number or the memory used by them and their
+ * decoded cels exceeds its limit. Pictures are kept the same way.
  */
 class GfxCache {
 public:
@@ -51,9 +110,32 @@ public:
 
 	byte kernelViewGetColorAtCoordinate(GuiResourceId viewId, int16 loopNo, int16 celNo, int16 x, int16 y);
 
+	uint32 getViewCacheHits() const { return _viewCacheHits; }
+	uint32 getViewCacheMisses() const { return _viewCacheMisses; }
+	uint32 getViewCacheEvictions() const { return _viewCacheEvictions; }
+	uint getViewCacheCount() const { return _cachedViews.size(); }
+	uint32 getViewCacheMemoryUsage() const;
+	uint32 getViewCacheMemoryLimit() const { return _maxViewMemory; }
+
+	/**
+	 * Looks for a picture drawn with the parameters of key onto the screen
+	 * saved in bitsBefore. Returns 0 if there is none.
+	 */
+	const CachedPicture *findPicture(const CachedPicture &key, const byte *bitsBefore);
+	/** Takes ownership of the picture and its bits. */
+	void addPicture(CachedPicture *picture);
+
+	uint32 getPictureCacheHits() const { return _pictureCacheHits; }
+	uint32 getPictureCacheMisses() const { return _pictureCacheMisses; }
+	uint getPictureCacheCount() const { return _cachedPictures.size(); }
+	uint32 getPictureCacheMemoryUsage() const;
+
 private:
 	void purgeFontCache();
 	void purgeViewCache();
+	void purgePictureCache();
+	void evictViews();
+	void evictPictures(uint32 neededMemory);
 
 	ResourceManager *_resMan;
 	GfxScreen *_screen;
@@ -61,6 +143,17 @@ private:
 
 	FontCache _cachedFonts;
 	ViewCache _cachedViews;
+	PictureCache _cachedPictures;
+
+	uint32 _maxViewMemory;
+	uint32 _viewAccessCounter;
+	uint32 _viewCacheHits;
+	uint32 _viewCacheMisses;
+	uint32 _viewCacheEvictions;
+
+	uint32 _pictureAccessCounter;
+	uint32 _pictureCacheHits;
+	uint32 _pictureCacheMisses;
 };
 
 } // End of namespace Sci
@@ -549,6 +549,9 @@ void GfxFrameout::showVideo() {
 
 		g_system->delayMillis(10);
 	}
+
+	// The video was drawn directly to the backend screen
+	_screen->invalidateShownScreen();
 }
 
 void GfxFrameout::createPlaneItemList(reg_t planeObject, FrameoutList &itemList) {
@@ -832,7 +835,8 @@ void GfxFrameout::kernelFrameout() {
 
 	showCurrentScrollText();
 
-	_screen->copyToScreen();
+	// Everything got redrawn, but only pass on what actually changed
+	_screen->copyChangedToScreen();
 
 	g_sci->getEngineState()->_throttleTrigger = true;
 }
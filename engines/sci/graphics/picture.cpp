@@ -25,6 +25,7 @@
 
 #include "sci/sci.h"
 #include "sci/engine/state.h"
+#include "sci/graphics/cache.h"
 #include "sci/graphics/screen.h"
 #include "sci/graphics/palette.h"
 #include "sci/graphics/coordadjuster.h"
@@ -35,8 +36,8 @@ namespace Sci {
 
 //#define DEBUG_PICTURE_DRAW
 
-GfxPicture::GfxPicture(ResourceManager *resMan, GfxCoordAdjuster *coordAdjuster, GfxPorts *ports, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, bool EGAdrawingVisualize)
-	: _resMan(resMan), _coordAdjuster(coordAdjuster), _ports(ports), _screen(screen), _palette(palette), _resourceId(resourceId), _EGAdrawingVisualize(EGAdrawingVisualize) {
+GfxPicture::GfxPicture(ResourceManager *resMan, GfxCoordAdjuster *coordAdjuster, GfxPorts *ports, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, bool EGAdrawingVisualize, GfxCache *cache)
+	: _resMan(resMan), _coordAdjuster(coordAdjuster), _ports(ports), _screen(screen), _palette(palette), _cache(cache), _resourceId(resourceId), _EGAdrawingVisualize(EGAdrawingVisualize), _stateChanges(0) {
 	assert(resourceId != -1);
 	initData(resourceId);
 }
@@ -83,7 +84,10 @@ void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int1
 	default:
 		// VGA, EGA or Amiga vector data
 		_resourceType = SCI_PICTURE_TYPE_REGULAR;
-		drawVectorData(_resource->data, _resource->size);
+		if (_cache && !_addToFlag && !_EGAdrawingVisualize)
+			drawVectorDataCached(_resource->data, _resource->size);
+		else
+			drawVectorData(_resource->data, _resource->size);
 	}
 }
 
@@ -742,7 +746,7 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 					curPos += size;
 					break;
 				case PIC_OPX_EGA_SET_PRIORITY_TABLE:
-					_ports->priorityBandsInit(data + curPos);
+					priorityBandsInit(data + curPos);
 					curPos += 14;
 					break;
 				default:
@@ -765,7 +769,7 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 							curPos += 256 + 4 + 1024;
 						} else {
 							// Setting half of the Amiga palette
-							_palette->modifyAmigaPalette(&data[curPos]);
+							modifyAmigaPalette(&data[curPos]);
 							curPos += 32;
 						}
 					} else {
@@ -774,7 +778,7 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 							palette.colors[i].used = data[curPos++];
 							palette.colors[i].r = data[curPos++]; palette.colors[i].g = data[curPos++]; palette.colors[i].b = data[curPos++];
 						}
-						_palette->set(&palette, true);
+						setPalette(&palette);
 					}
 					break;
 				case PIC_OPX_VGA_EMBEDDED_VIEW: // draw cel
@@ -785,11 +789,11 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 					curPos += size;
 					break;
 				case PIC_OPX_VGA_PRIORITY_TABLE_EQDIST:
-					_ports->priorityBandsInit(-1, READ_LE_UINT16(data + curPos), READ_LE_UINT16(data + curPos + 2));
+					priorityBandsInit(READ_LE_UINT16(data + curPos), READ_LE_UINT16(data + curPos + 2));
 					curPos += 4;
 					break;
 				case PIC_OPX_VGA_PRIORITY_TABLE_EXPLICIT:
-					_ports->priorityBandsInit(data + curPos);
+					priorityBandsInit(data + curPos);
 					curPos += 14;
 					break;
 				default:
@@ -829,6 +833,116 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 	error("picture vector data without terminator");
 }
 
+/**
+ * Draws vector data onto the cleared screen, or restores the screen from the
+ * last time the picture was drawn onto the same screen contents. Replaying
+ * the vector data, especially the flood fills, is what makes entering a room
+ * slow in SCI0 games.
+ */
+void GfxPicture::drawVectorDataCached(byte *data, int size) {
+	Port *curPort = _ports->getPort();
+	Common::Rect screenRect(_screen->getWidth(), _screen->getHeight());
+	const byte screenMask = GFX_SCREEN_MASK_VISUAL | GFX_SCREEN_MASK_PRIORITY | GFX_SCREEN_MASK_CONTROL;
+
+	CachedPicture *picture = new CachedPicture();
+	picture->pictureId = _resourceId;
+	picture->mirrored = _mirroredFlag;
+	picture->EGApaletteNo = _EGApaletteNo;
+	picture->portTop = curPort->top;
+	picture->portLeft = curPort->left;
+	picture->portRect = curPort->rect;
+	picture->undithering = _screen->isUnditheringEnabled();
+	picture->bitsSize = _screen->bitsGetDataSize(screenRect, screenMask);
+	picture->bitsBefore = new byte[picture->bitsSize];
+	picture->bitsAfter = 0;
+	_screen->bitsSave(screenRect, screenMask, picture->bitsBefore);
+
+	const CachedPicture *cachedPicture = _cache->findPicture(*picture, picture->bitsBefore);
+	if (cachedPicture) {
+		delete[] picture->bitsBefore;
+		delete picture;
+
+		for (uint i = 0; i < cachedPicture->stateChanges.size(); i++)
+			applyStateChange(cachedPicture->stateChanges[i]);
+		_screen->bitsRestore(cachedPicture->bitsAfter);
+		if (!cachedPicture->ditheredPicColors.empty())
+			_screen->unditherSetDitheredBgColors(cachedPicture->ditheredPicColors.begin());
+		return;
+	}
+
+	_stateChanges = &picture->stateChanges;
+	drawVectorData(data, size);
+	_stateChanges = 0;
+
+	picture->bitsAfter = new byte[picture->bitsSize];
+	_screen->bitsSave(screenRect, screenMask, picture->bitsAfter);
+	const int16 *ditheredPicColors = _screen->unditherGetDitheredBgColors();
+	if (ditheredPicColors)
+		picture->ditheredPicColors = Common::Array<int16>(ditheredPicColors, DITHERED_BG_COLORS_SIZE);
+	_cache->addPicture(picture);
+}
+
+void GfxPicture::applyStateChange(const PictureStateChange &change) {
+	// The palette and ports functions take non-const data
+	PictureStateChange copy = change;
+
+	switch (change.type) {
+	case kPictureSetPalette:
+		_palette->set(&copy.palette, true);
+		break;
+	case kPictureModifyAmigaPalette:
+		_palette->modifyAmigaPalette(copy.data);
+		break;
+	case kPicturePriorityTable:
+		_ports->priorityBandsInit(copy.data);
+		break;
+	case kPicturePriorityBands:
+		_ports->priorityBandsInit(-1, change.top, change.bottom);
+		break;
+	}
+}
+
+void GfxPicture::setPalette(Palette *palette) {
+	if (_stateChanges) {
+		PictureStateChange change;
+		change.type = kPictureSetPalette;
+		change.palette = *palette;
+		_stateChanges->push_back(change);
+	}
+	_palette->set(palette, true);
+}
+
+void GfxPicture::modifyAmigaPalette(byte *data) {
+	if (_stateChanges) {
+		PictureStateChange change;
+		change.type = kPictureModifyAmigaPalette;
+		memcpy(change.data, data, 32);
+		_stateChanges->push_back(change);
+	}
+	_palette->modifyAmigaPalette(data);
+}
+
+void GfxPicture::priorityBandsInit(byte *data) {
+	if (_stateChanges) {
+		PictureStateChange change;
+		change.type = kPicturePriorityTable;
+		memcpy(change.data, data, 14);
+		_stateChanges->push_back(change);
+	}
+	_ports->priorityBandsInit(data);
+}
+
+void GfxPicture::priorityBandsInit(int16 top, int16 bottom) {
+	if (_stateChanges) {
+		PictureStateChange change;
+		change.type = kPicturePriorityBands;
+		change.top = top;
+		change.bottom = bottom;
+		_stateChanges->push_back(change);
+	}
+	_ports->priorityBandsInit(-1, top, bottom);
+}
+
 bool GfxPicture::vectorIsNonOpcode(byte pixel) {
 	if (pixel >= PIC_OP_FIRST)
 		return false;
@@ -23,6 +23,8 @@
 #ifndef SCI_GRAPHICS_PICTURE_H
 #define SCI_GRAPHICS_PICTURE_H
 
+#include "common/array.h"
+
 namespace Sci {
 
 #define SCI_PATTERN_CODE_RECTANGLE 0x10
@@ -35,9 +37,12 @@ enum {
 	SCI_PICTURE_TYPE_SCI32		= 2
 };
 
+class GfxCache;
 class GfxPorts;
 class GfxScreen;
 class GfxPalette;
+struct Palette;
+struct PictureStateChange;
 
 /**
  * Picture class, handles loading and displaying of picture resources
@@ -45,7 +50,7 @@ class GfxPalette;
  */
 class GfxPicture {
 public:
-	GfxPicture(ResourceManager *resMan, GfxCoordAdjuster *coordAdjuster, GfxPorts *ports, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, bool EGAdrawingVisualize = false);
+	GfxPicture(ResourceManager *resMan, GfxCoordAdjuster *coordAdjuster, GfxPorts *ports, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, bool EGAdrawingVisualize = false, GfxCache *cache = 0);
 	~GfxPicture();
 
 	GuiResourceId getResourceId();
@@ -67,6 +72,12 @@ private:
 	void drawSci11Vga();
 	void drawCelData(byte *inbuffer, int size, int headerPos, int rlePos, int literalPos, int16 drawX, int16 drawY, int16 pictureX, int16 pictureY);
 	void drawVectorData(byte *data, int size);
+	void drawVectorDataCached(byte *data, int size);
+	void applyStateChange(const PictureStateChange &change);
+	void setPalette(Palette *palette);
+	void modifyAmigaPalette(byte *data);
+	void priorityBandsInit(byte *data);
+	void priorityBandsInit(int16 top, int16 bottom);
 	bool vectorIsNonOpcode(byte pixel);
 	void vectorGetAbsCoords(byte *data, int &curPos, int16 &x, int16 &y);
 	void vectorGetAbsCoordsNoMirror(byte *data, int &curPos, int16 &x, int16 &y);
@@ -85,6 +96,7 @@ private:
 	GfxPorts *_ports;
 	GfxScreen *_screen;
 	GfxPalette *_palette;
+	GfxCache *_cache;
 
 	int16 _resourceId;
 	Resource *_resource;
@@ -98,6 +110,10 @@ private:
 
 	// If true, we will show the whole EGA drawing process...
 	bool _EGAdrawingVisualize;
+
+	// Palette and priority band changes are recorded in here, while drawing
+	//  a picture for the cache
+	Common::Array<PictureStateChange> *_stateChanges;
 };
 
 } // End of namespace Sci
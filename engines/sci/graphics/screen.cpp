@@ -120,6 +120,9 @@ GfxScreen::GfxScreen(ResourceManager *resMan) : _resMan(resMan) {
 	// Sets display screen to be actually displayed
 	_activeScreen = _displayScreen;
 
+	_shownScreen = 0;
+	_shownScreenValid = false;
+
 	_picNotValid = 0;
 	_picNotValidSci11 = 0;
 	_unditheringEnabled = true;
@@ -161,10 +164,56 @@ GfxScreen::~GfxScreen() {
 	free(_priorityScreen);
 	free(_controlScreen);
 	free(_displayScreen);
+	free(_shownScreen);
 }
 
 void GfxScreen::copyToScreen() {
 	g_system->copyRectToScreen(_activeScreen, _displayWidth, 0, 0, _displayWidth, _displayHeight);
+	_shownScreenValid = false;
+}
+
+/**
+ * Copies only the parts of the active screen to the backend, which changed
+ * since the last call. This is used by SCI32, which redraws the whole screen
+ * each frame, even though usually only a few screen items have changed.
+ */
+void GfxScreen::copyChangedToScreen() {
+	if (!_shownScreen)
+		_shownScreen = (byte *)malloc(_displayPixels);
+
+	if (!_shownScreenValid) {
+		copyToScreen();
+		memcpy(_shownScreen, _activeScreen, _displayPixels);
+		_shownScreenValid = true;
+		return;
+	}
+
+	int y = 0;
+	while (y < _displayHeight) {
+		if (!memcmp(_activeScreen + y * _displayWidth, _shownScreen + y * _displayWidth, _displayWidth)) {
+			y++;
+			continue;
+		}
+
+		// Collect the consecutive changed lines into one rect
+		const int top = y;
+		int left = _displayWidth, right = 0;
+		do {
+			const byte *cur = _activeScreen + y * _displayWidth;
+			byte *shown = _shownScreen + y * _displayWidth;
+			int lineLeft = 0, lineRight = _displayWidth;
+			while (cur[lineLeft] == shown[lineLeft])
+				lineLeft++;
+			while (cur[lineRight - 1] == shown[lineRight - 1])
+				lineRight--;
+			memcpy(shown + lineLeft, cur + lineLeft, lineRight - lineLeft);
+			left = MIN(left, lineLeft);
+			right = MAX(right, lineRight);
+			y++;
+		} while (y < _displayHeight && memcmp(_activeScreen + y * _displayWidth, _shownScreen + y * _displayWidth, _displayWidth));
+
+		g_system->copyRectToScreen(_activeScreen + top * _displayWidth + left, _displayWidth, left, top, right - left, y - top);
+	}
 }
 
 void GfxScreen::copyFromScreen(byte *buffer) {
@@ -182,6 +231,7 @@ void GfxScreen::kernelSyncWithFramebuffer() {
 }
 
 void GfxScreen::copyRectToScreen(const Common::Rect &rect) {
+	_shownScreenValid = false;
 	if (!_upscaledHires)  {
 		g_system->copyRectToScreen(_activeScreen + rect.top * _displayWidth + rect.left, _displayWidth, rect.left, rect.top, rect.width(), rect.height());
 	} else {
@@ -197,10 +247,12 @@ void GfxScreen::copyRectToScreen(const Common::Rect &rect) {
 void GfxScreen::copyDisplayRectToScreen(const Common::Rect &rect) {
 	if (!_upscaledHires)
 		error("copyDisplayRectToScreen: not in upscaled hires mode");
+	_shownScreenValid = false;
 	g_system->copyRectToScreen(_activeScreen + rect.top * _displayWidth + rect.left, _displayWidth, rect.left, rect.top, rect.width(), rect.height());
 }
 
 void GfxScreen::copyRectToScreen(const Common::Rect &rect, int16 x, int16 y) {
+	_shownScreenValid = false;
 	if (!_upscaledHires)  {
 		g_system->copyRectToScreen(_activeScreen + rect.top * _displayWidth + rect.left, _displayWidth, x, y, rect.width(), rect.height());
 	} else {
@@ -220,30 +272,6 @@ byte GfxScreen::getDrawingMask(byte color, byte prio, byte control) {
 	return flag;
 }
 
-void GfxScreen::putPixel(int x, int y, byte drawMask, byte color, byte priority, byte control) {
-	int offset = y * _pitch + x;
-
-	if (drawMask & GFX_SCREEN_MASK_VISUAL) {
-		_visualScreen[offset] = color;
-		if (!_upscaledHires) {
-			_displayScreen[offset] = color;
-		} else {
-			int displayOffset = _upscaledMapping[y] * _displayWidth + x * 2;
-			int heightOffsetBreak = (_upscaledMapping[y + 1] - _upscaledMapping[y]) * _displayWidth;
-			int heightOffset = 0;
-			do {
-				_displayScreen[displayOffset + heightOffset] = color;
-				_displayScreen[displayOffset + heightOffset + 1] = color;
-				heightOffset += _displayWidth;
-			} while (heightOffset != heightOffsetBreak);
-		}
-	}
-	if (drawMask & GFX_SCREEN_MASK_PRIORITY)
-		_priorityScreen[offset] = priority;
-	if (drawMask & GFX_SCREEN_MASK_CONTROL)
-		_controlScreen[offset] = control;
-}
-
 /**
  * This is used to put font pixels onto the screen - we adjust differently, so that we won't
  *  do triple pixel lines in any case on upscaled hires. That way the font will not get distorted
@@ -367,36 +395,6 @@ byte GfxScreen::getControl(int x, int y) {
 	return _controlScreen[y * _pitch + x];
 }
 
-byte GfxScreen::isFillMatch(int16 x, int16 y, byte screenMask, byte t_color, byte t_pri, byte t_con, bool isEGA) {
-	int offset = y * _pitch + x;
-	byte match = 0;
-
-	if (screenMask & GFX_SCREEN_MASK_VISUAL) {
-		if (!isEGA) {
-			if (*(_visualScreen + offset) == t_color)
-				match |= GFX_SCREEN_MASK_VISUAL;
-		} else {
-			// In EGA games a pixel in the framebuffer is only 4 bits. We store
-			// a full byte per pixel to allow undithering, but when comparing
-			// pixels for flood-fill purposes, we should only compare the
-			// visible color of a pixel.
-
-			byte c = *(_visualScreen + offset);
-			if ((x ^ y) & 1)
-				c = (c ^ (c >> 4)) & 0x0F;
-			else
-				c = c & 0x0F;
-			if (c == t_color)
-				match |= GFX_SCREEN_MASK_VISUAL;
-		}
-	}
-	if ((screenMask & GFX_SCREEN_MASK_PRIORITY) && *(_priorityScreen + offset) == t_pri)
-		match |= GFX_SCREEN_MASK_PRIORITY;
-	if ((screenMask & GFX_SCREEN_MASK_CONTROL) && *(_controlScreen + offset) == t_con)
-		match |= GFX_SCREEN_MASK_CONTROL;
-	return match;
-}
-
 int GfxScreen::bitsGetDataSize(Common::Rect rect, byte mask) {
 	int byteCount = sizeof(rect) + sizeof(mask);
 	int pixels = rect.width() * rect.height();
@@ -646,6 +644,10 @@ int16 *GfxScreen::unditherGetDitheredBgColors() {
 		return NULL;
 }
 
+void GfxScreen::unditherSetDitheredBgColors(const int16 *colors) {
+	memcpy(&_ditheredPicColors, colors, sizeof(_ditheredPicColors));
+}
+
 void GfxScreen::debugShowMap(int mapNo) {
 	// We cannot really support changing maps when in upscaledHires mode
 	if (_upscaledHires)
@@ -73,6 +73,9 @@ public:
 	byte getColorDefaultVectorData() { return _colorDefaultVectorData; }
 
 	void copyToScreen();
+	void copyChangedToScreen();
+	/** Has to be called when anything else draws directly to the backend screen. */
+	void invalidateShownScreen() { _shownScreenValid = false; }
 	void copyFromScreen(byte *buffer);
 	void kernelSyncWithFramebuffer();
 	void copyRectToScreen(const Common::Rect &rect);
@@ -80,7 +83,33 @@ public:
 	void copyRectToScreen(const Common::Rect &rect, int16 x, int16 y);
 
 	byte getDrawingMask(byte color, byte prio, byte control);
-	void putPixel(int x, int y, byte drawMask, byte color, byte prio, byte control);
+	/**
+	 * Puts a pixel on the selected planes. This and isFillMatch() are called
+	 * for every pixel of vector pictures and flood fills, so they are inline.
+	 */
+	void putPixel(int x, int y, byte drawMask, byte color, byte priority, byte control) {
+		int offset = y * _pitch + x;
+
+		if (drawMask & GFX_SCREEN_MASK_VISUAL) {
+			_visualScreen[offset] = color;
+			if (!_upscaledHires) {
+				_displayScreen[offset] = color;
+			} else {
+				int displayOffset = _upscaledMapping[y] * _displayWidth + x * 2;
+				int heightOffsetBreak = (_upscaledMapping[y + 1] - _upscaledMapping[y]) * _displayWidth;
+				int heightOffset = 0;
+				do {
+					_displayScreen[displayOffset + heightOffset] = color;
+					_displayScreen[displayOffset + heightOffset + 1] = color;
+					heightOffset += _displayWidth;
+				} while (heightOffset != heightOffsetBreak);
+			}
+		}
+		if (drawMask & GFX_SCREEN_MASK_PRIORITY)
+			_priorityScreen[offset] = priority;
+		if (drawMask & GFX_SCREEN_MASK_CONTROL)
+			_controlScreen[offset] = control;
+	}
 	void putFontPixel(int startingY, int x, int y, byte color);
 	void putPixelOnDisplay(int x, int y, byte color);
 	void drawLine(Common::Point startPoint, Common::Point endPoint, byte color, byte prio, byte control);
@@ -101,7 +130,35 @@ public:
 	byte getVisual(int x, int y);
 	byte getPriority(int x, int y);
 	byte getControl(int x, int y);
-	byte isFillMatch(int16 x, int16 y, byte drawMask, byte t_color, byte t_pri, byte t_con, bool isEGA);
+	byte isFillMatch(int16 x, int16 y, byte screenMask, byte t_color, byte t_pri, byte t_con, bool isEGA) {
+		int offset = y * _pitch + x;
+		byte match = 0;
+
+		if (screenMask & GFX_SCREEN_MASK_VISUAL) {
+			if (!isEGA) {
+				if (*(_visualScreen + offset) == t_color)
+					match |= GFX_SCREEN_MASK_VISUAL;
+			} else {
+				// In EGA games a pixel in the framebuffer is only 4 bits. We store
+				// a full byte per pixel to allow undithering, but when comparing
+				// pixels for flood-fill purposes, we should only compare the
+				// visible color of a pixel.
+
+				byte c = *(_visualScreen + offset);
+				if ((x ^ y) & 1)
+					c = (c ^ (c >> 4)) & 0x0F;
+				else
+					c = c & 0x0F;
+				if (c == t_color)
+					match |= GFX_SCREEN_MASK_VISUAL;
+			}
+		}
+		if ((screenMask & GFX_SCREEN_MASK_PRIORITY) && *(_priorityScreen + offset) == t_pri)
+			match |= GFX_SCREEN_MASK_PRIORITY;
+		if ((screenMask & GFX_SCREEN_MASK_CONTROL) && *(_controlScreen + offset) == t_con)
+			match |= GFX_SCREEN_MASK_CONTROL;
+		return match;
+	}
 
 	int bitsGetDataSize(Common::Rect rect, byte mask);
 	void bitsSave(Common::Rect rect, byte mask, byte *memoryPtr);
@@ -118,6 +175,7 @@ public:
 	// Force a color combination as a dithered color
 	void ditherForceDitheredColor(byte color);
 	int16 *unditherGetDitheredBgColors();
+	void unditherSetDitheredBgColors(const int16 *colors);
 
 	void debugShowMap(int mapNo);
 
@@ -177,6 +235,13 @@ private:
 	 */
 	byte *_activeScreen;
 
+	/**
+	 * Copy of what copyChangedToScreen() last passed to the backend, only
+	 * valid while nothing else has been copied to the backend screen.
+	 */
+	byte *_shownScreen;
+	bool _shownScreenValid;
+
 	/**
 	 * This variable defines, if upscaled hires is active and what upscaled mode
 	 * is used.
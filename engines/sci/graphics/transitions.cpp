@@ -275,6 +275,7 @@ void GfxTransitions::copyRectToScreen(const Common::Rect rect, bool blackoutFlag
 	if (!blackoutFlag) {
 		_screen->copyRectToScreen(rect);
 	} else {
+		_screen->invalidateShownScreen();
 		Graphics::Surface *surface = g_system->lockScreen();
 		if (!_screen->getUpscaledHires()) {
 			surface->fillRect(rect, 0);
@@ -445,6 +446,7 @@ void GfxTransitions::scrollCopyOldToScreen(Common::Rect screenRect, int16 x, int
 		_screen->adjustToUpscaledCoordinates(y, x);
 	}
 	oldScreenPtr += screenRect.left + screenRect.top * screenWidth;
+	_screen->invalidateShownScreen();
 	g_system->copyRectToScreen(oldScreenPtr, screenWidth, x, y, screenRect.width(), screenRect.height());
 }
 
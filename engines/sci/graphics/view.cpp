@@ -31,7 +31,8 @@
 namespace Sci {
 
 GfxView::GfxView(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId)
-	: _resMan(resMan), _screen(screen), _palette(palette), _resourceId(resourceId) {
+	: _resMan(resMan), _screen(screen), _palette(palette), _resourceId(resourceId),
+	_decodedSize(0), _scalingCelWidth(-1), _scalingCelHeight(-1), _scalingScaleX(0), _scalingScaleY(0) {
 	assert(resourceId != -1);
 	_coordAdjuster = g_sci->_gfxCoordAdjuster;
 	initData(resourceId);
@@ -590,6 +591,7 @@ const byte *GfxView::getBitmap(int16 loopNo, int16 celNo) {
 	// allocating memory to store cel's bitmap
 	int pixelCount = width * height;
 	_loop[loopNo].cel[celNo].rawBitmap = new byte[pixelCount];
+	_decodedSize += pixelCount;
 	byte *pBitmap = _loop[loopNo].cel[celNo].rawBitmap;
 
 	// unpack the actual cel bitmap data
@@ -776,68 +778,83 @@ void GfxView::draw(const Common::Rect &rect, const Common::Rect &clipRect, const
 }
 
 /**
- * We don't fully follow sierra sci here, I did the scaling algo myself and it
- * is definitely not pixel-perfect with the one sierra is using. It shouldn't
- * matter because the scaled cel rect is definitely the same as in sierra sci.
+ * Creates the tables mapping scaled to unscaled cel coordinates, used by
+ * drawScaled(). They are kept until a different cel size or scale is drawn.
  */
-void GfxView::drawScaled(const Common::Rect &rect, const Common::Rect &clipRect, const Common::Rect &clipRectTranslated,
-			int16 loopNo, int16 celNo, byte priority, int16 scaleX, int16 scaleY) {
-	const Palette *palette = _embeddedPal ? &_viewPalette : &_palette->_sysPalette;
-	const CelInfo *celInfo = getCelInfo(loopNo, celNo);
-	const byte *bitmap = getBitmap(loopNo, celNo);
-	const int16 celHeight = celInfo->height;
-	const int16 celWidth = celInfo->width;
-	const byte clearKey = celInfo->clearKey;
-	const byte drawMask = priority > 15 ? GFX_SCREEN_MASK_VISUAL : GFX_SCREEN_MASK_VISUAL|GFX_SCREEN_MASK_PRIORITY;
-	uint16 scalingX[640];
-	uint16 scalingY[480];
-	int16 scaledWidth, scaledHeight;
-	int pixelNo, scaledPixel, scaledPixelNo, prevScaledPixelNo;
-
-	if (_embeddedPal)
-		// Merge view palette in...
-		_palette->set(&_viewPalette, false);
-
-	scaledWidth = (celInfo->width * scaleX) >> 7;
-	scaledHeight = (celInfo->height * scaleY) >> 7;
+void GfxView::createScalingTables(int16 celWidth, int16 celHeight, int16 scaleX, int16 scaleY) {
+	int16 scaledWidth = (celWidth * scaleX) >> 7;
+	int16 scaledHeight = (celHeight * scaleY) >> 7;
 	scaledWidth = CLIP<int16>(scaledWidth, 0, _screen->getWidth());
 	scaledHeight = CLIP<int16>(scaledHeight, 0, _screen->getHeight());
-
-	// Do we really need to do this?!
-	//memset(scalingX, 0, sizeof(scalingX));
-	//memset(scalingY, 0, sizeof(scalingY));
+	int pixelNo, scaledPixel, scaledPixelNo, prevScaledPixelNo;
 
 	// Create height scaling table
 	pixelNo = 0;
 	scaledPixel = scaledPixelNo = prevScaledPixelNo = 0;
 	while (pixelNo < celHeight) {
 		scaledPixelNo = scaledPixel >> 7;
-		assert(scaledPixelNo < ARRAYSIZE(scalingY));
+		assert(scaledPixelNo < ARRAYSIZE(_scalingY));
 		for (; prevScaledPixelNo <= scaledPixelNo; prevScaledPixelNo++)
-			scalingY[prevScaledPixelNo] = pixelNo;
+			_scalingY[prevScaledPixelNo] = pixelNo;
 		pixelNo++;
 		scaledPixel += scaleY;
 	}
 	pixelNo--;
 	scaledPixelNo++;
 	for (; scaledPixelNo < scaledHeight; scaledPixelNo++)
-		scalingY[scaledPixelNo] = pixelNo;
+		_scalingY[scaledPixelNo] = pixelNo;
 
 	// Create width scaling table
 	pixelNo = 0;
 	scaledPixel = scaledPixelNo = prevScaledPixelNo = 0;
 	while (pixelNo < celWidth) {
 		scaledPixelNo = scaledPixel >> 7;
-		assert(scaledPixelNo < ARRAYSIZE(scalingX));
+		assert(scaledPixelNo < ARRAYSIZE(_scalingX));
 		for (; prevScaledPixelNo <= scaledPixelNo; prevScaledPixelNo++)
-			scalingX[prevScaledPixelNo] = pixelNo;
+			_scalingX[prevScaledPixelNo] = pixelNo;
 		pixelNo++;
 		scaledPixel += scaleX;
 	}
 	pixelNo--;
 	scaledPixelNo++;
 	for (; scaledPixelNo < scaledWidth; scaledPixelNo++)
-		scalingX[scaledPixelNo] = pixelNo;
+		_scalingX[scaledPixelNo] = pixelNo;
+
+	_scalingCelWidth = celWidth;
+	_scalingCelHeight = celHeight;
+	_scalingScaleX = scaleX;
+	_scalingScaleY = scaleY;
+}
+
+/**
+ * We don't fully follow sierra sci here, I did the scaling algo myself and it
+ * is definitely not pixel-perfect with the one sierra is using. It shouldn't
+ * matter because the scaled cel rect is definitely the same as in sierra sci.
+ */
+void GfxView::drawScaled(const Common::Rect &rect, const Common::Rect &clipRect, const Common::Rect &clipRectTranslated,
+			int16 loopNo, int16 celNo, byte priority, int16 scaleX, int16 scaleY) {
+	const Palette *palette = _embeddedPal ? &_viewPalette : &_palette->_sysPalette;
+	const CelInfo *celInfo = getCelInfo(loopNo, celNo);
+	const byte *bitmap = getBitmap(loopNo, celNo);
+	const int16 celHeight = celInfo->height;
+	const int16 celWidth = celInfo->width;
+	const byte clearKey = celInfo->clearKey;
+	const byte drawMask = priority > 15 ? GFX_SCREEN_MASK_VISUAL : GFX_SCREEN_MASK_VISUAL|GFX_SCREEN_MASK_PRIORITY;
+	int16 scaledWidth, scaledHeight;
+
+	if (_embeddedPal)
+		// Merge view palette in...
+		_palette->set(&_viewPalette, false);
+
+	scaledWidth = (celInfo->width * scaleX) >> 7;
+	scaledHeight = (celInfo->height * scaleY) >> 7;
+	scaledWidth = CLIP<int16>(scaledWidth, 0, _screen->getWidth());
+	scaledHeight = CLIP<int16>(scaledHeight, 0, _screen->getHeight());
+
+	if (celWidth != _scalingCelWidth || celHeight != _scalingCelHeight || scaleX != _scalingScaleX || scaleY != _scalingScaleY)
+		createScalingTables(celWidth, celHeight, scaleX, scaleY);
+	const uint16 *scalingX = _scalingX;
+	const uint16 *scalingY = _scalingY;
 
 	scaledWidth = MIN(clipRect.width(), scaledWidth);
 	scaledHeight = MIN(clipRect.height(), scaledHeight);
@@ -849,8 +866,8 @@ void GfxView::drawScaled(const Common::Rect &rect, const Common::Rect &clipRect,
 	if (offsetX < 0 || offsetY < 0)
 		return;
 
-	assert(scaledHeight + offsetY <= ARRAYSIZE(scalingY));
-	assert(scaledWidth + offsetX <= ARRAYSIZE(scalingX));
+	assert(scaledHeight + offsetY <= ARRAYSIZE(_scalingY));
+	assert(scaledWidth + offsetX <= ARRAYSIZE(_scalingX));
 	for (int y = 0; y < scaledHeight; y++) {
 		for (int x = 0; x < scaledWidth; x++) {
 			const byte color = bitmap[scalingY[y + offsetY] * celWidth + scalingX[x + offsetX]];
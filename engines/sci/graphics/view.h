@@ -87,7 +87,12 @@ public:
 
 	byte getColorAtCoordinate(int16 loopNo, int16 celNo, int16 x, int16 y);
 
+	/** Returns the memory used by the view resource and its decoded cels. */
+	uint32 getMemoryUsage() const { return _resourceSize + _decodedSize; }
+
 private:
+	void createScalingTables(int16 celWidth, int16 celHeight, int16 scaleX, int16 scaleY);
+
 	void initData(GuiResourceId resourceId);
 	void unpackCel(int16 loopNo, int16 celNo, byte *outPtr, uint32 pixelCount);
 	void unditherBitmap(byte *bitmap, int16 width, int16 height, byte clearKey);
@@ -118,6 +123,16 @@ private:
 	// this is not set for some views in laura bow 2 floppy and signals that the view shall never get scaled
 	//  even if scaleX/Y are set (inside kAnimate)
 	bool _isScaleable;
+
+	// total size of the cel bitmaps decoded so far
+	uint32 _decodedSize;
+
+	// scaling tables of the last drawScaled() call, scaled actors usually
+	//  get redrawn with the same cel size and scale frame after frame
+	uint16 _scalingX[640];
+	uint16 _scalingY[480];
+	int16 _scalingCelWidth, _scalingCelHeight;
+	int16 _scalingScaleX, _scalingScaleY;
 };
 
 } // End of namespace Sci
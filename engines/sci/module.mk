@@ -29,6 +29,7 @@ MODULE_OBJS := \
 	engine/kvideo.o \
 	engine/message.o \
 	engine/object.o \
+	engine/profiler.o \
 	engine/savegame.o \
 	engine/script.o \
 	engine/scriptdebug.o \
@@ -22,9 +22,11 @@
 
 // Resource library
 
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/memstream.h"
 #include "common/textconsole.h"
 
 #include "sci/resource.h"
@@ -191,6 +193,7 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : _resMan(resMan), _i
 	_source = NULL;
 	_header = NULL;
 	_headerSize = 0;
+	_loadCost = 1;
 }
 
 Resource::~Resource() {
@@ -890,6 +893,14 @@ void ResourceManager::init(bool initFromFallbackDetector) {
 	_memoryLocked = 0;
 	_memoryLRU = 0;
 	_LRU.clear();
+	_maxMemoryLRU = kDefaultMaxMemory;
+	_cacheEvictions = 0;
+	for (int i = 0; i < kResourceTypeInvalid; i++) {
+		_maxMemoryLRUType[i] = 0;
+		_memoryLRUType[i] = 0;
+		_cacheHits[i] = 0;
+		_cacheMisses[i] = 0;
+	}
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 
@@ -941,6 +952,8 @@ void ResourceManager::init(bool initFromFallbackDetector) {
 
 	debugC(1, kDebugLevelResMan, "resMan: Detected %s", getSciVersionDesc(getSciVersion()));
 
+	initCacheBudgets();
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -994,6 +1007,7 @@ void ResourceManager::removeFromLRU(Resource *res) {
 	}
 	_LRU.remove(res);
 	_memoryLRU -= res->size;
+	_memoryLRUType[res->getType()] -= res->size;
 	res->_status = kResStatusAllocated;
 }
 
@@ -1004,6 +1018,7 @@ void ResourceManager::addToLRU(Resource *res) {
 	}
 	_LRU.push_front(res);
 	_memoryLRU += res->size;
+	_memoryLRUType[res->getType()] += res->size;
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s.%03d (%d bytes) to lru control: %d bytes total",
 	      getResourceTypeName(res->type), res->number, res->size,
@@ -1029,15 +1044,58 @@ void ResourceManager::printLRU() {
 	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
 }
 
-void ResourceManager::freeOldResources() {
-	while (MAX_MEMORY < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = *_LRU.reverse_begin();
-		removeFromLRU(goner);
-		goner->unalloc();
+void ResourceManager::initCacheBudgets() {
+	_maxMemoryLRU = (getSciVersion() >= SCI_VERSION_2) ? kDefaultMaxMemorySci32 : kDefaultMaxMemory;
+	if (ConfMan.hasKey("sci_resource_cache_size"))
+		_maxMemoryLRU = CLIP<int>(ConfMan.getInt("sci_resource_cache_size"), 0, kMaxCacheSizeKB) * 1024;
+
+	// Audio is large, cheap to load and rarely played twice in a row. Keep
+	// it from pushing views, pics and scripts out of the cache.
+	const uint32 audioBudget = _maxMemoryLRU / 4;
+	_maxMemoryLRUType[kResourceTypeAudio] = audioBudget;
+	_maxMemoryLRUType[kResourceTypeAudio36] = audioBudget;
+	_maxMemoryLRUType[kResourceTypeSync36] = audioBudget;
+}
+
+void ResourceManager::freeLRUResource(Resource *res) {
+	removeFromLRU(res);
+	res->unalloc();
+	_cacheEvictions++;
 #ifdef SCI_VERBOSE_RESMAN
-		debug("resMan-debug: LRU: Freeing %s.%03d (%d bytes)", getResourceTypeName(goner->type), goner->number, goner->size);
+	debug("resMan-debug: LRU: Freeing %s.%03d (%d bytes)", getResourceTypeName(res->type), res->number, res->size);
 #endif
+}
+
+void ResourceManager::freeOldResources() {
+	// Resource types exceeding their own budget give up their oldest
+	// resources first
+	for (int type = 0; type < kResourceTypeInvalid; type++) {
+		if (!_maxMemoryLRUType[type] || _memoryLRUType[type] <= _maxMemoryLRUType[type])
+			continue;
+
+		Common::List<Resource *>::iterator it = _LRU.reverse_begin();
+		while (_memoryLRUType[type] > _maxMemoryLRUType[type]) {
+			assert(it != _LRU.end());
+			Resource *res = *it;
+			--it;
+			if (res->getType() == type)
+				freeLRUResource(res);
+		}
+	}
+
+	// Then free resources until the total budget is met. Among the oldest
+	// few, the one which is cheapest to load again goes first. When all of
+	// them cost the same, this is plain LRU.
+	while ((int)_maxMemoryLRU < _memoryLRU) {
+		assert(!_LRU.empty());
+		Common::List<Resource *>::iterator it = _LRU.reverse_begin();
+		Resource *goner = *it;
+		for (int i = 1; i < kEvictionWindow && it != _LRU.begin(); i++) {
+			--it;
+			if ((*it)->_loadCost < goner->_loadCost)
+				goner = *it;
+		}
+		freeLRUResource(goner);
 	}
 }
 
@@ -1060,10 +1118,14 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_status == kResStatusNoMalloc) {
+		_cacheMisses[retval->getType()]++;
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		removeFromLRU(retval);
+	} else {
+		_cacheHits[retval->getType()]++;
+		if (retval->_status == kResStatusEnqueued)
+			removeFromLRU(retval);
+	}
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
 
@@ -1594,7 +1656,16 @@ int ResourceManager::readResourceMapSCI0(ResourceSource *map) {
 		fileStream = file;
 	}
 
+	// Parse the map from memory: readSpan() borrows the data of memory
+	// mapped files, and needs just one read call otherwise
+	Common::StreamSpan mapData;
 	fileStream->seek(0, SEEK_SET);
+	if (!fileStream->readSpan(fileStream->size(), mapData)) {
+		delete fileStream;
+		warning("Error while reading %s", map->getLocationName().c_str());
+		return SCI_ERROR_RESMAP_NOT_FOUND;
+	}
+	Common::MemoryReadStream mapStream(mapData.data(), mapData.size());
 
 	byte bMask = (_mapVersion >= kResVersionSci1Middle) ? 0xF0 : 0xFC;
 	byte bShift = (_mapVersion >= kResVersionSci1Middle) ? 28 : 26;
@@ -1603,12 +1674,12 @@ int ResourceManager::readResourceMapSCI0(ResourceSource *map) {
 		// King's Quest 5 FM-Towns uses a 7 byte version of the SCI1 Middle map,
 		// splitting the type from the id.
 		if (_mapVersion == kResVersionKQ5FMT)
-			type = convertResType(fileStream->readByte());
+			type = convertResType(mapStream.readByte());
 
-		id = fileStream->readUint16LE();
-		offset = fileStream->readUint32LE();
+		id = mapStream.readUint16LE();
+		offset = mapStream.readUint32LE();
 
-		if (fileStream->eos() || fileStream->err()) {
+		if (mapStream.eos() || mapStream.err()) {
 			delete fileStream;
 			warning("Error while reading %s", map->getLocationName().c_str());
 			return SCI_ERROR_RESMAP_NOT_FOUND;
@@ -1642,7 +1713,7 @@ int ResourceManager::readResourceMapSCI0(ResourceSource *map) {
 
 			addResource(resId, source, offset & (((~bMask) << 24) | 0xFFFFFF));
 		}
-	} while (!fileStream->eos());
+	} while (!mapStream.eos());
 
 	delete fileStream;
 	return 0;
@@ -1662,6 +1733,15 @@ int ResourceManager::readResourceMapSCI1(ResourceSource *map) {
 		fileStream = file;
 	}
 
+	// Parse the map from memory, see readResourceMapSCI0()
+	Common::StreamSpan mapData;
+	if (!fileStream->readSpan(fileStream->size(), mapData)) {
+		delete fileStream;
+		warning("Error while reading %s", map->getLocationName().c_str());
+		return SCI_ERROR_RESMAP_NOT_FOUND;
+	}
+	Common::MemoryReadStream mapStream(mapData.data(), mapData.size());
+
 	resource_index_t resMap[32];
 	memset(resMap, 0, sizeof(resource_index_t) * 32);
 	byte type = 0, prevtype = 0;
@@ -1671,8 +1751,8 @@ int ResourceManager::readResourceMapSCI1(ResourceSource *map) {
 	// Read resource type and offsets to resource offsets block from .MAP file
 	// The last entry has type=0xFF (0x1F) and offset equals to map file length
 	do {
-		type = fileStream->readByte() & 0x1F;
-		resMap[type].wOffset = fileStream->readUint16LE();
+		type = mapStream.readByte() & 0x1F;
+		resMap[type].wOffset = mapStream.readUint16LE();
 		resMap[prevtype].wSize = (resMap[type].wOffset
 		                          - resMap[prevtype].wOffset) / nEntrySize;
 		prevtype = type;
@@ -1683,18 +1763,18 @@ int ResourceManager::readResourceMapSCI1(ResourceSource *map) {
 	for (type = 0; type < 32; type++) {
 		if (resMap[type].wOffset == 0) // this resource does not exist in map
 			continue;
-		fileStream->seek(resMap[type].wOffset);
+		mapStream.seek(resMap[type].wOffset);
 		for (int i = 0; i < resMap[type].wSize; i++) {
-			uint16 number = fileStream->readUint16LE();
+			uint16 number = mapStream.readUint16LE();
 			int volume_nr = 0;
 			if (_mapVersion == kResVersionSci11) {
 				// offset stored in 3 bytes
-				fileOffset = fileStream->readUint16LE();
-				fileOffset |= fileStream->readByte() << 16;
+				fileOffset = mapStream.readUint16LE();
+				fileOffset |= mapStream.readByte() << 16;
 				fileOffset <<= 1;
 			} else {
 				// offset/volume stored in 4 bytes
-				fileOffset = fileStream->readUint32LE();
+				fileOffset = mapStream.readUint32LE();
 				if (_mapVersion < kResVersionSci11) {
 					volume_nr = fileOffset >> 28; // most significant 4 bits
 					fileOffset &= 0x0FFFFFFF;     // least significant 28 bits
@@ -1702,7 +1782,7 @@ int ResourceManager::readResourceMapSCI1(ResourceSource *map) {
 					// in SCI32 it's a plain offset
 				}
 			}
-			if (fileStream->eos() || fileStream->err()) {
+			if (mapStream.eos() || mapStream.err()) {
 				delete fileStream;
 				warning("Error while reading %s", map->getLocationName().c_str());
 				return SCI_ERROR_RESMAP_NOT_FOUND;
@@ -2002,6 +2082,20 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 		return SCI_ERROR_UNKNOWN_COMPRESSION;
 	}
 
+	// Decompressing is more expensive than just reading the data again
+	switch (compression) {
+	case kCompNone:
+		_loadCost = 1;
+		break;
+	case kCompDCL:
+	case kCompSTACpack:
+		_loadCost = 3;
+		break;
+	default:
+		_loadCost = 2;
+		break;
+	}
+
 	data = new byte[size];
 	_status = kResStatusAllocated;
 	errorNum = data ? dec->unpack(file, data, szPacked, size) : SCI_ERROR_RESOURCE_TOO_BIG;
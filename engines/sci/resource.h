@@ -242,6 +242,7 @@ protected:
 	uint16 _lockers; /**< Number of places where this resource was locked */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
+	byte _loadCost; /**< Relative cost of loading the resource again once it got freed */
 
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
@@ -378,13 +379,30 @@ public:
 	 */
 	ResourceType convertResType(byte type);
 
+	/** Returns the budget for resources under LRU control, in bytes. */
+	uint32 getCacheBudget() const { return _maxMemoryLRU; }
+	/** Returns the budget of a resource type, or the total budget if the type has none. */
+	uint32 getCacheBudget(ResourceType type) const { return _maxMemoryLRUType[type] ? _maxMemoryLRUType[type] : _maxMemoryLRU; }
+	/** Returns the number of resource bytes under LRU control. */
+	uint32 getCacheMemoryUsed() const { return _memoryLRU; }
+	uint32 getCacheMemoryUsed(ResourceType type) const { return _memoryLRUType[type]; }
+	/** Returns the number of resource bytes in locked memory. */
+	uint32 getLockedMemory() const { return _memoryLocked; }
+	uint32 getCacheHits(ResourceType type) const { return _cacheHits[type]; }
+	uint32 getCacheMisses(ResourceType type) const { return _cacheMisses[type]; }
+	uint32 getCacheEvictions() const { return _cacheEvictions; }
+
 protected:
-	// Maximum number of bytes to allow being allocated for resources
-	// Note: maxMemory will not be interpreted as a hard limit, only as a restriction
-	// for resources which are not explicitly locked. However, a warning will be
-	// issued whenever this limit is exceeded.
+	// Default number of bytes to allow being allocated for resources which are
+	// not locked. It can be changed with the "sci_resource_cache_size" config
+	// key (in KB).
+	// Note: this will not be interpreted as a hard limit, only as a restriction
+	// for resources which are not explicitly locked.
 	enum {
-		MAX_MEMORY = 256 * 1024	// 256KB
+		kDefaultMaxMemory = 256 * 1024,			// 256KB
+		kDefaultMaxMemorySci32 = 4096 * 1024,	// 4MB
+		kMaxCacheSizeKB = 1024 * 1024,			// 1GB, keeps the budget within an int
+		kEvictionWindow = 8 ///< Number of oldest resources considered for eviction
 	};
 
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
@@ -392,6 +410,12 @@ protected:
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
 	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	uint32 _maxMemoryLRU;	///< Budget for resources under LRU control
+	uint32 _maxMemoryLRUType[kResourceTypeInvalid];	///< Budgets per resource type, 0 if none
+	uint32 _memoryLRUType[kResourceTypeInvalid];	///< Resource bytes under LRU control per type
+	uint32 _cacheHits[kResourceTypeInvalid];		///< Lookups of resources which were in memory
+	uint32 _cacheMisses[kResourceTypeInvalid];		///< Lookups of resources which had to be loaded
+	uint32 _cacheEvictions;	///< Number of resources freed by the LRU
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -445,7 +469,9 @@ protected:
 
 	Common::SeekableReadStream *getVolumeFile(ResourceSource *source);
 	void loadResource(Resource *res);
+	void initCacheBudgets();
 	void freeOldResources();
+	void freeLRUResource(Resource *res);
 	void addResource(ResourceId resId, ResourceSource *src, uint32 offset, uint32 size = 0);
 	Resource *updateResource(ResourceId resId, ResourceSource *src, uint32 size);
 	void removeAudioResource(ResourceId resId);
@@ -35,6 +35,7 @@
 #include "sci/engine/features.h"
 #include "sci/engine/message.h"
 #include "sci/engine/object.h"
+#include "sci/engine/profiler.h"
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/script.h"	// for script_adjust_opcode_formats
@@ -91,7 +92,9 @@ SciEngine::SciEngine(OSystem *syst, const ADGameDescription *desc, SciGameId gam
 	_vocabularyLanguage = 1; // we load english vocabulary on startup
 	_eventMan = 0;
 	_console = 0;
+	_scriptProfiler = 0;
 	_opcode_formats = 0;
+	_opcodeLayouts = 0;
 
 	// Set up the engine specific debug levels
 	DebugMan.addDebugChannel(kDebugLevelError, "Error", "Script error debugging");
@@ -174,6 +177,7 @@ SciEngine::~SciEngine() {
 	delete _kernel;
 	delete _vocabulary;
 	delete _console;
+	delete _scriptProfiler;
 	delete _features;
 	delete _gfxMacIconBar;
 
@@ -182,6 +186,7 @@ SciEngine::~SciEngine() {
 	delete _gamestate;
 
 	delete[] _opcode_formats;
+	delete[] _opcodeLayouts;
 
 	delete _resMan;	// should be deleted last
 	g_sci = 0;
@@ -237,6 +242,7 @@ Common::Error SciEngine::run() {
 
 	// Create debugger console. It requires GFX and _gamestate to be initialized
 	_console = new Console(this);
+	_scriptProfiler = new ScriptProfiler();
 
 	// The game needs to be initialized before the graphics system is initialized, as
 	// the graphics code checks parts of the seg manager upon initialization (e.g. for
@@ -51,6 +51,7 @@ class ResourceManager;
 class Kernel;
 class GameFeatures;
 class Console;
+class ScriptProfiler;
 class AudioPlayer;
 class SoundCommandParser;
 class EventManager;
@@ -352,8 +353,10 @@ public:
 	GameFeatures *_features;
 
 	opcode_format (*_opcode_formats)[4];
+	PMachineOpcodeLayout *_opcodeLayouts; ///< indexed by extended opcode, see readPMachineInstruction()
 
 	DebugState _debugState;
+	ScriptProfiler *_scriptProfiler; ///< see the "profiler" console command
 
 	Common::MacResManager *getMacExecutable() { return &_macExecutable; }
 
@@ -346,6 +346,7 @@ void AkosRenderer::setCostume(int costume, int shadow) {
 	akcd = _vm->findResourceData(MKTAG('A','K','C','D'), akos);
 	akpl = _vm->findResourceData(MKTAG('A','K','P','L'), akos);
 	_codec = READ_LE_UINT16(&akhd->codec);
+	_costumeId = costume;
 	akct = _vm->findResourceData(MKTAG('A','K','C','T'), akos);
 	rgbs = _vm->findResourceData(MKTAG('R','G','B','S'), akos);
 
@@ -778,7 +779,7 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 	int num_colors;
 	bool use_scaling;
 	int i, j;
-	int skip = 0, startScaleIndexX, startScaleIndexY;
+	int skip = 0, skipCols = 0, startScaleIndexX, startScaleIndexY;
 	Common::Rect rect;
 	int step;
 	byte drawFlag = 1;
@@ -947,7 +948,7 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 
 		if (skip > 0) {
 			v1.skip_width -= skip;
-			codec1_ignorePakCols(v1, skip);
+			skipCols = skip;
 			v1.x = v1.boundsRect.left;
 		} else {
 			skip = rect.right - v1.boundsRect.right;
@@ -962,7 +963,7 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 			skip = rect.right - v1.boundsRect.right + 1;
 		if (skip > 0) {
 			v1.skip_width -= skip;
-			codec1_ignorePakCols(v1, skip)	;
+			skipCols = skip;
 			v1.x = v1.boundsRect.right - 1;
 		} else {
 			skip = (v1.boundsRect.left -1) - rect.left;
@@ -996,11 +997,96 @@ byte AkosRenderer::codec1(int xmoveCur, int ymoveCur) {
 
 	v1.destptr = (byte *)_out.pixels + v1.y * _out.pitch + v1.x * _vm->_bytesPerPixel;
 
-	codec1_genericDecode(v1);
+	// Scaled frames can only be cached for the built-in scale tables, as a
+	// custom table may change behind our back.
+	int scaleTable = -1;
+	if (v1.scaletable == smallCostumeScaleTableAKOS)
+		scaleTable = CostumeFrameCache::kScaleTableAkosSmall;
+	else if (v1.scaletable == bigCostumeScaleTable)
+		scaleTable = CostumeFrameCache::kScaleTableAkosBig;
+
+	if (_vm->_costumeFrameCache && !_actorHitMode && (!use_scaling || scaleTable != -1)) {
+		CostumeFrameCache *cache = _vm->_costumeFrameCache;
+		CostumeFrameCache::Key key(_costumeId, _srcptr - akcd, CostumeFrameCache::kCodec1, v1.shr, _width, _height);
+		const CostumeFrameCache::Frame *frame = cache->getCodec1Frame(key, _srcptr, v1.mask);
+		if (use_scaling) {
+			frame = cache->getScaledCodec1Frame(key, *frame, v1.scaletable, scaleTable,
+				_scaleX, _scaleY, v1.scaleXindex, v1.scaleYindex, v1.scaleXstep, skipCols, v1.skip_width, true);
+			codec1_cachedDecode(v1, *frame, 0, frame->width);
+		} else {
+			codec1_cachedDecode(v1, *frame, skipCols, v1.skip_width);
+		}
+	} else {
+		if (skipCols)
+			codec1_ignorePakCols(v1, skipCols);
+		codec1_genericDecode(v1);
+	}
 
 	return drawFlag;
 }
 
+void AkosRenderer::codec1_cachedDecode(Codec1 &v1, const CostumeFrameCache::Frame &frame, int firstCol, int numCols) {
+	const byte *mask, *src;
+	byte *dst;
+	byte maskbit;
+	int y, row;
+	uint16 color, pcolor;
+	bool masked, clippedX;
+
+	src = frame.pixels + firstCol * frame.height;
+
+	while (numCols-- > 0) {
+		y = v1.y;
+		dst = v1.destptr;
+		maskbit = revBitMask(v1.x & 7);
+		mask = _vm->getMaskBuffer(v1.x - (_vm->_virtscr[kMainVirtScreen].xstart & 7), v1.y, _zbuf);
+		clippedX = (v1.x < 0 || v1.x >= v1.boundsRect.right);
+
+		for (row = 0; row < frame.height; row++) {
+			color = src[row];
+			masked = (y < v1.boundsRect.top || y >= v1.boundsRect.bottom) || clippedX || (*mask & maskbit);
+
+			if (color && !masked) {
+				pcolor = _palette[color];
+				if (_shadow_mode == 1) {
+					if (pcolor == 13)
+						pcolor = _shadow_table[*dst];
+				} else if (_shadow_mode == 2) {
+					error("codec1_spec2"); // TODO
+				} else if (_shadow_mode == 3) {
+					if (_vm->_game.features & GF_16BIT_COLOR) {
+						uint16 srcColor = (pcolor >> 1) & 0x7DEF;
+						uint16 dstColor = (READ_UINT16(dst) >> 1) & 0x7DEF;
+						pcolor = srcColor + dstColor;
+					} else if (_vm->_game.heversion >= 90) {
+						pcolor = (pcolor << 8) + *dst;
+						pcolor = xmap[pcolor];
+					} else if (pcolor < 8) {
+						pcolor = (pcolor << 8) + *dst;
+						pcolor = _shadow_table[pcolor];
+					}
+				}
+				if (_vm->_bytesPerPixel == 2) {
+					WRITE_UINT16(dst, pcolor);
+				} else {
+					*dst = pcolor;
+				}
+			}
+			dst += _out.pitch;
+			mask += _numStrips;
+			y++;
+		}
+
+		// Columns which the scale table drops have already been removed
+		// from scaled frames, so every column moves one pixel on.
+		v1.x += v1.scaleXstep;
+		if (v1.x < 0 || v1.x >= v1.boundsRect.right)
+			return;
+		v1.destptr += v1.scaleXstep * _vm->_bytesPerPixel;
+		src += frame.height;
+	}
+}
+
 void AkosRenderer::markRectAsDirty(Common::Rect rect) {
 	rect.left -= _vm->_virtscr[kMainVirtScreen].xstart & 7;
 	rect.right -= _vm->_virtscr[kMainVirtScreen].xstart & 7;
@@ -1054,6 +1140,18 @@ byte AkosRenderer::codec5(int xmoveCur, int ymoveCur) {
 	bdd.srcwidth = _width;
 	bdd.srcheight = _height;
 
+	bdd.decoded = 0;
+	if (_vm->_costumeFrameCache && _width > 0 && _height > 0) {
+		CostumeFrameCache::Key key(_costumeId, _srcptr - akcd, CostumeFrameCache::kCodecBomp, 0, _width, _height);
+		const CostumeFrameCache::Frame *frame = _vm->_costumeFrameCache->find(key);
+		if (!frame) {
+			CostumeFrameCache::Frame *newFrame = _vm->_costumeFrameCache->insert(key, _width, _height);
+			decompressBomp(newFrame->pixels, _srcptr, _width, _height);
+			frame = newFrame;
+		}
+		bdd.decoded = frame->pixels;
+	}
+
 	bdd.scale_x = 255;
 	bdd.scale_y = 255;
 
@@ -1146,7 +1244,7 @@ void AkosRenderer::akos16DecodeLine(byte *buf, int32 numbytes, int32 dir) {
 }
 
 void AkosRenderer::akos16Decompress(byte *dest, int32 pitch, const byte *src, int32 t_width, int32 t_height, int32 dir,
-		int32 numskip_before, int32 numskip_after, byte transparency, int maskLeft, int maskTop, int zBuf) {
+		int32 numskip_before, int32 numskip_after, byte transparency, int maskLeft, int maskTop, int zBuf, const byte *decoded) {
 	byte *tmp_buf = _akos16.buffer;
 	int maskpitch;
 	byte *maskptr;
@@ -1157,10 +1255,14 @@ void AkosRenderer::akos16Decompress(byte *dest, int32 pitch, const byte *src, in
 		tmp_buf += (t_width - 1);
 	}
 
-	akos16SetupBitReader(src);
+	if (decoded) {
+		decoded += numskip_before;
+	} else {
+		akos16SetupBitReader(src);
 
-	if (numskip_before != 0) {
-		akos16SkipData(numskip_before);
+		if (numskip_before != 0) {
+			akos16SkipData(numskip_before);
+		}
 	}
 
 	maskpitch = _numStrips;
@@ -1170,12 +1272,18 @@ void AkosRenderer::akos16Decompress(byte *dest, int32 pitch, const byte *src, in
 	assert(t_height > 0);
 	assert(t_width > 0);
 	while (t_height--) {
-		akos16DecodeLine(tmp_buf, t_width, dir);
+		if (decoded) {
+			for (int32 i = 0; i < t_width; i++)
+				tmp_buf[i * dir] = decoded[i];
+			decoded += t_width + numskip_after;
+		} else {
+			akos16DecodeLine(tmp_buf, t_width, dir);
+		}
 		bompApplyMask(_akos16.buffer, maskptr, maskbit, t_width, transparency);
 		bool HE7Check = (_vm->_game.heversion == 70);
 		bompApplyShadow(_shadow_mode, _shadow_table, _akos16.buffer, dest, t_width, transparency, HE7Check);
 
-		if (numskip_after != 0)	{
+		if (!decoded && numskip_after != 0)	{
 			akos16SkipData(numskip_after);
 		}
 		dest += pitch;
@@ -1290,7 +1398,22 @@ byte AkosRenderer::codec16(int xmoveCur, int ymoveCur) {
 
 	byte *dst = (byte *)_out.pixels + height_unk * _out.pitch + width_unk * _vm->_bytesPerPixel;
 
-	akos16Decompress(dst, _out.pitch, _srcptr, cur_x, out_height, dir, numskip_before, numskip_after, transparency, clip.left, clip.top, _zbuf);
+	// The AKOS16 stream is one continuous bit stream, so the whole frame
+	// can be decoded in one go and cached.
+	const byte *decoded = 0;
+	if (_vm->_costumeFrameCache) {
+		CostumeFrameCache::Key key(_costumeId, _srcptr - akcd, CostumeFrameCache::kCodecAkos16, 0, _width, _height);
+		const CostumeFrameCache::Frame *frame = _vm->_costumeFrameCache->find(key);
+		if (!frame) {
+			CostumeFrameCache::Frame *newFrame = _vm->_costumeFrameCache->insert(key, _width, _height);
+			akos16SetupBitReader(_srcptr);
+			akos16DecodeLine(newFrame->pixels, _width * _height, 1);
+			frame = newFrame;
+		}
+		decoded = frame->pixels;
+	}
+
+	akos16Decompress(dst, _out.pitch, _srcptr, cur_x, out_height, dir, numskip_before, numskip_after, transparency, clip.left, clip.top, _zbuf, decoded);
 	return 0;
 }
 
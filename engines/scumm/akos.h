@@ -55,6 +55,7 @@ protected:
 class AkosRenderer : public BaseCostumeRenderer {
 protected:
 	uint16 _codec;
+	int _costumeId;
 
 	// actor _palette
 	uint16 _palette[256];
@@ -88,6 +89,8 @@ protected:
 public:
 	AkosRenderer(ScummEngine *scumm) : BaseCostumeRenderer(scumm) {
 		_useBompPalette = false;
+		_codec = 0;
+		_costumeId = 0;
 		akhd = 0;
 		akpl = 0;
 		akci = 0;
@@ -113,13 +116,14 @@ protected:
 
 	byte codec1(int xmoveCur, int ymoveCur);
 	void codec1_genericDecode(Codec1 &v1);
+	void codec1_cachedDecode(Codec1 &v1, const CostumeFrameCache::Frame &frame, int firstCol, int numCols);
 	byte codec5(int xmoveCur, int ymoveCur);
 	byte codec16(int xmoveCur, int ymoveCur);
 	byte codec32(int xmoveCur, int ymoveCur);
 	void akos16SetupBitReader(const byte *src);
 	void akos16SkipData(int32 numskip);
 	void akos16DecodeLine(byte *buf, int32 numbytes, int32 dir);
-	void akos16Decompress(byte *dest, int32 pitch, const byte *src, int32 t_width, int32 t_height, int32 dir, int32 numskip_before, int32 numskip_after, byte transparency, int maskLeft, int maskTop, int zBuf);
+	void akos16Decompress(byte *dest, int32 pitch, const byte *src, int32 t_width, int32 t_height, int32 dir, int32 numskip_before, int32 numskip_after, byte transparency, int maskLeft, int maskTop, int zBuf, const byte *decoded);
 
 	void markRectAsDirty(Common::Rect rect);
 };
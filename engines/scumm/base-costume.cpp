@@ -23,6 +23,9 @@
 
 #include "scumm/base-costume.h"
 #include "scumm/costume.h"
+#include "scumm/scumm.h"
+
+#include "common/debug-channels.h"
 
 namespace Scumm {
 
@@ -74,6 +77,228 @@ void BaseCostumeRenderer::codec1_ignorePakCols(Codec1 &v1, int num) {
 	} while (1);
 }
 
+bool CostumeFrameCache::Key::operator==(const Key &k) const {
+	return costume == k.costume && offset == k.offset && codec == k.codec && shr == k.shr &&
+		width == k.width && height == k.height && scaled == k.scaled &&
+		scaleX == k.scaleX && scaleY == k.scaleY && table == k.table &&
+		scaleXstep == k.scaleXstep && skipUnadvanced == k.skipUnadvanced &&
+		scaleXindex == k.scaleXindex && scaleYindex == k.scaleYindex &&
+		firstCol == k.firstCol && numCols == k.numCols;
+}
+
+uint CostumeFrameCache::KeyHash::operator()(const Key &k) const {
+	uint hash = k.costume * 31 + k.offset;
+	hash = hash * 31 + ((k.codec << 8) | k.shr);
+	hash = hash * 31 + ((k.width << 16) | k.height);
+	if (k.scaled) {
+		hash = hash * 31 + ((k.scaleX << 8) | k.scaleY);
+		hash = hash * 31 + ((k.scaleXindex << 16) | k.scaleYindex);
+		hash = hash * 31 + ((k.firstCol << 16) | k.numCols);
+		hash = hash * 31 + ((k.table << 2) | ((k.scaleXstep > 0) << 1) | k.skipUnadvanced);
+	}
+	return hash;
+}
+
+CostumeFrameCache::CostumeFrameCache(uint32 memoryBudget)
+	: _memoryBudget(memoryBudget), _memoryUsage(0), _hits(0), _misses(0) {
+}
+
+CostumeFrameCache::~CostumeFrameCache() {
+	clear();
+}
+
+const CostumeFrameCache::Frame *CostumeFrameCache::find(const Key &key) {
+	EntryMap::iterator i = _entries.find(key);
+	if (i == _entries.end()) {
+		_misses++;
+		return 0;
+	}
+
+	_hits++;
+
+	// Move the entry to the front of the LRU list
+	Entry *entry = i->_value;
+	_lru.erase(entry->lru);
+	_lru.push_front(entry);
+	entry->lru = _lru.begin();
+
+	return &entry->frame;
+}
+
+CostumeFrameCache::Frame *CostumeFrameCache::insert(const Key &key, int width, int height, bool withAdvance) {
+	assert(!_entries.contains(key));
+
+	uint32 size = width * height + (withAdvance ? width : 0) + sizeof(Entry);
+
+	// Make room first. The most recently used entry is always kept, as the
+	// caller may still be using it (e.g. when building a scaled frame).
+	while (!_lru.empty() && _lru.size() > 1 && _memoryUsage + size > _memoryBudget)
+		remove(_lru.back());
+
+	Entry *entry = new Entry;
+	entry->key = key;
+	entry->frame.width = width;
+	entry->frame.height = height;
+	entry->frame.pixels = new byte[MAX(width * height, 1)];
+	entry->frame.advance = withAdvance ? new byte[MAX(width, 1)] : 0;
+	entry->size = size;
+
+	_lru.push_front(entry);
+	entry->lru = _lru.begin();
+	_entries[key] = entry;
+	_memoryUsage += size;
+
+	return &entry->frame;
+}
+
+void CostumeFrameCache::remove(Entry *entry) {
+	_entries.erase(entry->key);
+	_lru.erase(entry->lru);
+	_memoryUsage -= entry->size;
+
+	delete[] entry->frame.pixels;
+	delete[] entry->frame.advance;
+	delete entry;
+}
+
+void CostumeFrameCache::invalidate(int costume) {
+	EntryList::iterator i = _lru.begin();
+	while (i != _lru.end()) {
+		Entry *entry = *i;
+		++i;
+		if (entry->key.costume == costume)
+			remove(entry);
+	}
+}
+
+void CostumeFrameCache::clear() {
+	while (!_lru.empty())
+		remove(_lru.front());
+}
+
+void CostumeFrameCache::setMemoryBudget(uint32 budget) {
+	_memoryBudget = budget;
+	while (!_lru.empty() && _memoryUsage > _memoryBudget)
+		remove(_lru.back());
+}
+
+const CostumeFrameCache::Frame *CostumeFrameCache::getCodec1Frame(const Key &key, const byte *src, byte mask) {
+	const Frame *cached = find(key);
+	if (cached)
+		return cached;
+
+	Frame *frame = insert(key, key.width, key.height);
+	const byte *start = src;
+	byte *dst = frame->pixels;
+	int num = key.width * key.height;
+
+	// The RLE runs continue across column boundaries, so the whole frame
+	// decodes as one long run of pixels, column by column.
+	while (num > 0) {
+		byte len = *src++;
+		byte color = len >> key.shr;
+		int run = len & mask;
+		if (!run)
+			run = *src++;
+		// The renderers count runs down in a byte, so 0 stands for 256
+		if (!run)
+			run = 256;
+		if (run > num)
+			run = num;
+		memset(dst, color, run);
+		dst += run;
+		num -= run;
+	}
+
+	if (DebugMan.isDebugChannelEnabled(DEBUG_ACTORS) && !checkCodec1Frame(*frame, key, start, mask))
+		warning("CostumeFrameCache: codec1 frame %d/0x%X decodes differently from the renderer", key.costume, key.offset);
+
+	return frame;
+}
+
+bool CostumeFrameCache::checkCodec1Frame(const Frame &frame, const Key &key, const byte *src, byte mask) {
+	// Walk the RLE data the way the uncached renderers (and
+	// codec1_ignorePakCols) do, with the run length counted down in a byte.
+	const byte *pixel = frame.pixels;
+	int num = key.width * key.height;
+	while (num > 0) {
+		byte replen = *src++;
+		const byte repcolor = replen >> key.shr;
+		replen &= mask;
+		if (!replen)
+			replen = *src++;
+		do {
+			if (*pixel++ != repcolor)
+				return false;
+		} while (--num && --replen);
+	}
+	return true;
+}
+
+const CostumeFrameCache::Frame *CostumeFrameCache::getScaledCodec1Frame(const Key &frameKey, const Frame &frame, const byte *scaletable, byte table,
+		byte scaleX, byte scaleY, int scaleXindex, int scaleYindex, int scaleXstep, int firstCol, int numCols, bool skipUnadvanced) {
+	Key key = frameKey;
+	key.scaled = true;
+	key.scaleX = scaleX;
+	key.scaleY = scaleY;
+	key.table = table;
+	key.scaleXstep = scaleXstep;
+	key.skipUnadvanced = skipUnadvanced;
+	key.scaleXindex = scaleXindex;
+	key.scaleYindex = scaleYindex;
+	key.firstCol = firstCol;
+	key.numCols = numCols;
+
+	const Frame *cached = find(key);
+	if (cached)
+		return cached;
+
+	// The classic renderer keeps its scale indices in a byte, so they wrap
+	const int indexMask = (table == kScaleTableClassic) ? 0xFF : 0xFFFF;
+	int i;
+
+	Common::Array<uint16> rows;
+	int idx = scaleYindex;
+	for (i = 0; i < frame.height; i++) {
+		if (scaleY == 255 || scaletable[idx & indexMask] < scaleY)
+			rows.push_back(i);
+		idx++;
+	}
+	const int numRows = rows.size();
+
+	// Count the columns which get drawn
+	int outCols = 0;
+	bool draw = true;
+	idx = scaleXindex;
+	for (i = 0; i < numCols; i++) {
+		if (draw || !skipUnadvanced)
+			outCols++;
+		draw = (scaleX == 255 || scaletable[idx & indexMask] < scaleX);
+		idx += scaleXstep;
+	}
+
+	Frame *scaled = insert(key, outCols, numRows, !skipUnadvanced);
+	byte *dst = scaled->pixels;
+	int col = 0;
+	idx = scaleXindex;
+	draw = true;
+	for (i = 0; i < numCols; i++) {
+		bool advance = (scaleX == 255 || scaletable[idx & indexMask] < scaleX);
+		idx += scaleXstep;
+		if (draw || !skipUnadvanced) {
+			const byte *src = frame.pixels + (firstCol + i) * frame.height;
+			for (int r = 0; r < numRows; r++)
+				*dst++ = src[rows[r]];
+			if (scaled->advance)
+				scaled->advance[col] = advance;
+			col++;
+		}
+		draw = advance;
+	}
+
+	return scaled;
+}
+
 bool ScummEngine::isCostumeInUse(int cost) const {
 	int i;
 	Actor *a;
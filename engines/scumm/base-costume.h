@@ -24,6 +24,9 @@
 #define SCUMM_BASE_COSTUME_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/list.h"
 #include "scumm/actor.h"		// for CostumeData
 
 namespace Scumm {
@@ -47,6 +50,144 @@ class Actor;
 class ScummEngine;
 struct VirtScreen;
 
+/**
+ * Cache of decoded costume limb frames, shared by all costume renderers.
+ *
+ * Frames are stored as decoded palette indices (the palette is applied at
+ * draw time, as are masking and shadows), so one entry serves every actor
+ * using the same costume frame. Scaled codec1 draws additionally cache the
+ * rows and columns picked by the scale table for a given scale and start
+ * index. Entries are evicted least recently used first once the memory
+ * budget is exceeded, and all entries of a costume are dropped when the
+ * costume resource is nuked.
+ */
+class CostumeFrameCache {
+public:
+	enum {
+		kDefaultMemoryBudget = 4 * 1024 * 1024
+	};
+
+	/**
+	 * Layout of a cached frame. Codec1 frames are stored column by column
+	 * (like the RLE stream), BOMP and AKOS16 frames line by line.
+	 */
+	struct Frame {
+		int width, height;
+		byte *pixels;
+		/**
+		 * For scaled codec1 frames: per column, whether the destination x
+		 * position advances after drawing it. 0 means it always advances.
+		 */
+		byte *advance;
+	};
+
+	enum Codec {
+		kCodec1 = 1,
+		kCodecBomp = 5,
+		kCodecAkos16 = 16
+	};
+
+	enum ScaleTable {
+		kScaleTableClassic = 0,		///< smallCostumeScaleTable, indexed by a wrapping byte
+		kScaleTableAkosSmall = 1,
+		kScaleTableAkosBig = 2
+	};
+
+	struct Key {
+		int costume;
+		uint32 offset;
+		byte codec;
+		byte shr;
+		uint16 width, height;
+
+		// Only used by scaled codec1 frames
+		bool scaled;
+		byte scaleX, scaleY;
+		byte table;
+		int8 scaleXstep;
+		bool skipUnadvanced;
+		uint16 scaleXindex, scaleYindex;
+		uint16 firstCol, numCols;
+
+		Key() : costume(0), offset(0), codec(0), shr(0), width(0), height(0),
+			scaled(false), scaleX(255), scaleY(255), table(0), scaleXstep(0), skipUnadvanced(false),
+			scaleXindex(0), scaleYindex(0), firstCol(0), numCols(0) {}
+		Key(int c, uint32 off, byte cod, byte s, int w, int h) : costume(c), offset(off), codec(cod), shr(s), width(w), height(h),
+			scaled(false), scaleX(255), scaleY(255), table(0), scaleXstep(0), skipUnadvanced(false),
+			scaleXindex(0), scaleYindex(0), firstCol(0), numCols(0) {}
+
+		bool operator==(const Key &k) const;
+	};
+
+	CostumeFrameCache(uint32 memoryBudget = kDefaultMemoryBudget);
+	~CostumeFrameCache();
+
+	/** Look up a frame, returns 0 if it is not cached. */
+	const Frame *find(const Key &key);
+
+	/**
+	 * Add an entry for the given key and return its frame, whose pixels
+	 * (and, if requested, advance flags) the caller has to fill in.
+	 */
+	Frame *insert(const Key &key, int width, int height, bool withAdvance = false);
+
+	/** Decode a codec1 (RLE) frame, or return the cached copy. */
+	const Frame *getCodec1Frame(const Key &key, const byte *src, byte mask);
+
+	/**
+	 * Pick the rows and columns of a decoded codec1 frame which a scaled
+	 * draw would visit, or return the cached result.
+	 * If skipUnadvanced is set, columns drawn at the same x position as
+	 * their predecessor are dropped (AKOS semantics), otherwise they are
+	 * kept and overdraw it (classic costume semantics).
+	 */
+	const Frame *getScaledCodec1Frame(const Key &frameKey, const Frame &frame, const byte *scaletable, byte table,
+		byte scaleX, byte scaleY, int scaleXindex, int scaleYindex, int scaleXstep, int firstCol, int numCols, bool skipUnadvanced);
+
+	/** Drop all cached frames of a costume. */
+	void invalidate(int costume);
+
+	/** Drop all cached frames. */
+	void clear();
+
+	void setMemoryBudget(uint32 budget);
+	uint32 getMemoryBudget() const { return _memoryBudget; }
+	uint32 getMemoryUsage() const { return _memoryUsage; }
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+
+private:
+	struct Entry;
+
+	struct KeyHash {
+		uint operator()(const Key &k) const;
+	};
+
+	typedef Common::List<Entry *> EntryList;
+	typedef Common::HashMap<Key, Entry *, KeyHash> EntryMap;
+
+	struct Entry {
+		Key key;
+		Frame frame;
+		uint32 size;
+		EntryList::iterator lru;
+	};
+
+	void remove(Entry *entry);
+
+	/**
+	 * Compare a decoded codec1 frame against the RLE data, decoded the way
+	 * the uncached renderers do. Used when actor debugging is enabled.
+	 */
+	static bool checkCodec1Frame(const Frame &frame, const Key &key, const byte *src, byte mask);
+
+	EntryMap _entries;
+	EntryList _lru;
+	uint32 _memoryBudget;
+	uint32 _memoryUsage;
+	uint32 _hits, _misses;
+};
+
 class BaseCostumeLoader {
 protected:
 	ScummEngine *_vm;
@@ -231,6 +231,7 @@ void drawBomp(const BompDrawData &bd) {
 	}
 
 	src = bd.src;
+	const byte *decoded = bd.decoded;
 	dst = (byte *)bd.dst.pixels + bd.y * bd.dst.pitch + (bd.x + clip.left);
 
 	const byte maskbit = revBitMask((bd.x + clip.left) & 7);
@@ -275,11 +276,21 @@ void drawBomp(const BompDrawData &bd) {
 	// Loop over all lines
 	while (pos_y < clip.bottom) {
 		// Decode a single (bomp encoded) line, reversed if we are in mirror mode
-		if (bd.mirror)
-			bompDecodeLineReverse(line_buffer, src + 2, bd.srcwidth);
-		else
-			bompDecodeLine(line_buffer, src + 2, bd.srcwidth);
-		src += READ_LE_UINT16(src) + 2;
+		if (decoded) {
+			if (bd.mirror) {
+				for (int i = 0; i < bd.srcwidth; i++)
+					line_buffer[bd.srcwidth - 1 - i] = decoded[i];
+			} else {
+				memcpy(line_buffer, decoded, bd.srcwidth);
+			}
+			decoded += bd.srcwidth;
+		} else {
+			if (bd.mirror)
+				bompDecodeLineReverse(line_buffer, src + 2, bd.srcwidth);
+			else
+				bompDecodeLine(line_buffer, src + 2, bd.srcwidth);
+			src += READ_LE_UINT16(src) + 2;
+		}
 
 		// If vertical scaling is enabled, do it
 		if (bd.scale_y != 255) {
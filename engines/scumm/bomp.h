@@ -43,6 +43,12 @@ struct BompDrawData {
 	const byte *src;
 	int srcwidth, srcheight;
 
+	/**
+	 * Optional copy of the image with all lines already decoded (not
+	 * mirrored), to be used instead of decoding src line by line.
+	 */
+	const byte *decoded;
+
 	byte scale_x, scale_y;
 
 	byte *maskPtr;
@@ -28,6 +28,7 @@
 #include "scumm/scumm_v6.h"
 #include "scumm/util.h"
 
+#include "common/algorithm.h"
 #include "common/util.h"
 
 namespace Scumm {
@@ -87,6 +88,7 @@ struct Box {				/* Internal walkbox file format */
 
 
 static void getGates(const BoxCoords &box1, const BoxCoords &box2, Common::Point gateA[2], Common::Point gateB[2]);
+static bool boxesTouch(const BoxCoords &box1, const BoxCoords &box2);
 
 static bool compareSlope(const Common::Point &p1, const Common::Point &p2, const Common::Point &p3) {
 	return (p2.y - p1.y) * (p3.x - p1.x) <= (p3.y - p1.y) * (p2.x - p1.x);
@@ -720,18 +722,16 @@ int ScummEngine::getNextBox(byte from, byte to) {
 
 	if (_game.version == 0) {
 		// calculate shortest paths
-		byte *itineraryMatrix = (byte *)malloc(numOfBoxes * numOfBoxes);
-		calcItineraryMatrix(itineraryMatrix, numOfBoxes);
+		updateBoxGraph();
 
 		dest = to;
 		do {
-			dest = itineraryMatrix[numOfBoxes * from + dest];
+			dest = _boxGraph->getItinerary(from, dest);
 		} while (dest != Actor::kInvalidBox && !areBoxesNeighbors(from, dest));
 
 		if (dest == Actor::kInvalidBox)
 			dest = -1;
 
-		free(itineraryMatrix);
 		return dest;
 	} else if (_game.version <= 2) {
 		// The v2 box matrix is a real matrix with numOfBoxes rows and columns.
@@ -929,8 +929,9 @@ static void printMatrix(byte *boxm, int num) {
 	}
 }
 
-static void printMatrix2(byte *matrix, int num) {
+static void printMatrix2(const BoxGraph &graph) {
 	int i, j;
+	const int num = graph.getNumBoxes();
 	debug("    ");
 	for (i = 0; i < num; i++)
 		debug("%2d ", i);
@@ -938,7 +939,7 @@ static void printMatrix2(byte *matrix, int num) {
 	for (i = 0; i < num; i++) {
 		debug("%2d: ", i);
 		for (j = 0; j < num; j++) {
-			int val = matrix[i * num + j];
+			int val = graph.getItinerary(i, j);
 			if (val == Actor::kInvalidBox)
 				debug(" ? ");
 			else
@@ -949,33 +950,132 @@ static void printMatrix2(byte *matrix, int num) {
 }
 #endif
 
-/**
- * Computes shortest paths and stores them in the itinerary matrix.
- * Parameter "num" holds the number of rows (= number of columns).
- */
-void ScummEngine::calcItineraryMatrix(byte *itineraryMatrix, int num) {
-	int i, j, k;
-	byte *adjacentMatrix;
+BoxGraph::BoxGraph() : _numBoxes(0) {
+}
+
+void BoxGraph::reset() {
+	_numBoxes = 0;
+	_coords.clear();
+	_coordsValid.clear();
+	_touching.clear();
+	_links.clear();
+	_itinerary.clear();
+	_distances.clear();
+	_dirty.clear();
+}
+
+void BoxGraph::begin(int num) {
+	if (num == _numBoxes)
+		return;
 
-	const uint8 boxSize = (_game.version == 0) ? num : 64;
+	reset();
+	_numBoxes = num;
+	_coords.resize(num);
+	_coordsValid.resize(num);
+	_touching.resize(num * num);
+	_links.resize(num * num);
+	_itinerary.resize(num * num);
+	_distances.resize(num * num);
+	_dirty.resize(num);
+
+	for (int i = 0; i < num; i++) {
+		_coordsValid[i] = false;
+		_dirty[i] = true;
+		for (int j = 0; j < num; j++) {
+			_touching[i * num + j] = 0;
+			_links[i * num + j] = 0;
+			_itinerary[i * num + j] = (i == j) ? j : Actor::kInvalidBox;
+		}
+	}
+}
+
+bool BoxGraph::setCoords(int box, const BoxCoords &coords) {
+	const BoxCoords &old = _coords[box];
+	if (_coordsValid[box] && old.ul == coords.ul && old.ur == coords.ur &&
+			old.ll == coords.ll && old.lr == coords.lr)
+		return false;
+
+	_coords[box] = coords;
+	_coordsValid[box] = true;
+	return true;
+}
 
-	// Allocate the adjacent & itinerary matrices
-	adjacentMatrix = (byte *)malloc(boxSize * boxSize);
+void BoxGraph::setLink(int box1, int box2, bool linked) {
+	byte &link = _links[box1 * _numBoxes + box2];
+	if (link != (byte)linked) {
+		link = linked;
+		_dirty[box1] = true;
+		_dirty[box2] = true;
+	}
+}
+
+void BoxGraph::update() {
+	const int num = _numBoxes;
+	Common::Array<int> group, stack;
+	Common::Array<bool> seen;
+	seen.resize(num);
+	for (int i = 0; i < num; i++)
+		seen[i] = false;
+
+	// Split the boxes into groups which are connected by links in either
+	// direction. A group containing no box whose links changed is exactly
+	// the same as last time, and so are the itinerary rows of its boxes.
+	for (int i = 0; i < num; i++) {
+		if (seen[i])
+			continue;
+
+		bool dirty = false;
+		group.clear();
+		stack.push_back(i);
+		seen[i] = true;
+		while (!stack.empty()) {
+			const int box = stack.back();
+			stack.pop_back();
+			group.push_back(box);
+			dirty |= _dirty[box];
+			for (int j = 0; j < num; j++) {
+				if (!seen[j] && (_links[box * num + j] || _links[j * num + box])) {
+					seen[j] = true;
+					stack.push_back(j);
+				}
+			}
+		}
+
+		if (dirty) {
+			Common::sort(group.begin(), group.end());
+			updateGroup(group);
+		}
+	}
+
+	for (int i = 0; i < num; i++)
+		_dirty[i] = false;
+}
+
+/**
+ * Computes shortest paths between the boxes of a group and stores them in
+ * the itinerary matrix. The boxes of the group must be sorted, so that ties
+ * between routes of equal length are broken the same way as when running
+ * over all boxes of the room.
+ */
+void BoxGraph::updateGroup(const Common::Array<int> &group) {
+	const int num = _numBoxes;
+	const int size = group.size();
 
 	// Initialize the adjacent matrix: each box has distance 0 to itself,
 	// and distance 1 to its direct neighbors. Initially, it has distance
 	// 255 (= infinity) to all other boxes.
-	for (i = 0; i < num; i++) {
-		for (j = 0; j < num; j++) {
+	for (int g = 0; g < size; g++) {
+		const int i = group[g];
+		for (int j = 0; j < num; j++) {
 			if (i == j) {
-				adjacentMatrix[i * boxSize + j] = 0;
-				itineraryMatrix[i * boxSize + j] = j;
-			} else if (areBoxesNeighbors(i, j)) {
-				adjacentMatrix[i * boxSize + j] = 1;
-				itineraryMatrix[i * boxSize + j] = j;
+				_distances[i * num + j] = 0;
+				_itinerary[i * num + j] = j;
+			} else if (_links[i * num + j]) {
+				_distances[i * num + j] = 1;
+				_itinerary[i * num + j] = j;
 			} else {
-				adjacentMatrix[i * boxSize + j] = 255;
-				itineraryMatrix[i * boxSize + j] = Actor::kInvalidBox;
+				_distances[i * num + j] = 255;
+				_itinerary[i * num + j] = Actor::kInvalidBox;
 			}
 		}
 	}
@@ -986,23 +1086,68 @@ void ScummEngine::calcItineraryMatrix(byte *itineraryMatrix, int num) {
 	// a) extremly obfuscated
 	// b) incorrect: it didn't always find the shortest paths
 	// c) not any faster in reality for our sparse & small adjacent matrices
-	for (k = 0; k < num; k++) {
-		for (i = 0; i < num; i++) {
-			for (j = 0; j < num; j++) {
+	//
+	// Boxes outside of the group are unreachable from within it, so they
+	// can never shorten a route and are skipped.
+	for (int gk = 0; gk < size; gk++) {
+		const int k = group[gk];
+		for (int gi = 0; gi < size; gi++) {
+			const int i = group[gi];
+			for (int gj = 0; gj < size; gj++) {
+				const int j = group[gj];
 				if (i == j)
 					continue;
-				byte distIK = adjacentMatrix[boxSize * i + k];
-				byte distKJ = adjacentMatrix[boxSize * k + j];
-				if (adjacentMatrix[boxSize * i + j] > distIK + distKJ) {
-					adjacentMatrix[boxSize * i + j] = distIK + distKJ;
-					itineraryMatrix[boxSize * i + j] = itineraryMatrix[boxSize * i + k];
+				byte distIK = _distances[num * i + k];
+				byte distKJ = _distances[num * k + j];
+				if (_distances[num * i + j] > distIK + distKJ) {
+					_distances[num * i + j] = distIK + distKJ;
+					_itinerary[num * i + j] = _itinerary[num * i + k];
 				}
 			}
 		}
+	}
+}
+
+/**
+ * Brings the box graph up to date with the current boxes of the room.
+ */
+void ScummEngine::updateBoxGraph() {
+	const int num = getNumBoxes();
+	int i, j;
+
+	_boxGraph->begin(num);
+
+	if (_game.version == 0) {
+		for (i = 0; i < num; i++)
+			for (j = 0; j < num; j++)
+				_boxGraph->setLink(i, j, i != j && areBoxesNeighbors(i, j));
+		_boxGraph->update();
+		return;
+	}
 
+	Common::Array<BoxCoords> coords;
+	Common::Array<bool> moved, visible;
+	coords.resize(num);
+	moved.resize(num);
+	visible.resize(num);
+
+	for (i = 0; i < num; i++) {
+		coords[i] = getBoxCoordinates(i);
+		moved[i] = _boxGraph->setCoords(i, coords[i]);
+		visible[i] = !(getBoxFlags(i) & kBoxInvisible);
+	}
+
+	for (i = 0; i < num; i++) {
+		for (j = 0; j < num; j++) {
+			if (i == j)
+				continue;
+			if (moved[i] || moved[j])
+				_boxGraph->setTouching(i, j, boxesTouch(coords[i], coords[j]));
+			_boxGraph->setLink(i, j, visible[i] && visible[j] && _boxGraph->isTouching(i, j));
+		}
 	}
 
-	free(adjacentMatrix);
+	_boxGraph->update();
 }
 
 void ScummEngine::createBoxMatrix() {
@@ -1011,11 +1156,8 @@ void ScummEngine::createBoxMatrix() {
 	// The total number of boxes
 	num = getNumBoxes();
 
-	const uint8 boxSize = (_game.version == 0) ? num : 64;
-
 	// calculate shortest paths
-	byte *itineraryMatrix = (byte *)malloc(boxSize * boxSize);
-	calcItineraryMatrix(itineraryMatrix, num);
+	updateBoxGraph();
 
 	// "Compress" the distance matrix into the box matrix format used
 	// by the engine. The format is like this:
@@ -1037,10 +1179,10 @@ void ScummEngine::createBoxMatrix() {
 	for (i = 0; i < num; i++) {
 		addToMatrix(0xFF);
 		for (j = 0; j < num; j++) {
-			byte itinerary = itineraryMatrix[boxSize * i + j];
+			byte itinerary = _boxGraph->getItinerary(i, j);
 			if (itinerary != Actor::kInvalidBox) {
 				addToMatrix(j);
-				while (j < num - 1 && itinerary == itineraryMatrix[boxSize * i + (j + 1)])
+				while (j < num - 1 && itinerary == _boxGraph->getItinerary(i, j + 1))
 					j++;
 				addToMatrix(j);
 				addToMatrix(itinerary);
@@ -1052,26 +1194,26 @@ void ScummEngine::createBoxMatrix() {
 
 #if BOX_DEBUG
 	debug("Itinerary matrix:\n");
-	printMatrix2(itineraryMatrix, num);
+	printMatrix2(*_boxGraph);
 	debug("compressed matrix:\n");
 	printMatrix(getBoxMatrixBaseAddr(), num);
 #endif
-
-	free(itineraryMatrix);
 }
 
 /** Check if two boxes are neighbors. */
 bool ScummEngine::areBoxesNeighbors(int box1nr, int box2nr) {
-	Common::Point tmp;
-	BoxCoords box;
-	BoxCoords box2;
-
 	if ((getBoxFlags(box1nr) & kBoxInvisible) || (getBoxFlags(box2nr) & kBoxInvisible))
 		return false;
 
 	assert(_game.version >= 3);
-	box2 = getBoxCoordinates(box1nr);
-	box = getBoxCoordinates(box2nr);
+	return boxesTouch(getBoxCoordinates(box1nr), getBoxCoordinates(box2nr));
+}
+
+/** Check if two boxes share (part of) a side, regardless of their flags. */
+static bool boxesTouch(const BoxCoords &coords1, const BoxCoords &coords2) {
+	Common::Point tmp;
+	BoxCoords box = coords2;
+	BoxCoords box2 = coords1;
 
 	// Roughly, the idea of this algorithm is to search for sies of the given
 	// boxes that touch each other.
@@ -23,6 +23,7 @@
 #ifndef SCUMM_BOXES_H
 #define SCUMM_BOXES_H
 
+#include "common/array.h"
 #include "common/rect.h"
 
 namespace Scumm {
@@ -51,6 +52,67 @@ struct BoxCoords {			/* Box coordinates */
 
 int getClosestPtOnBox(const BoxCoords &box, int x, int y, int16& outX, int16& outY);
 
+/**
+ * The links between the walk boxes of a room and the itinerary matrix
+ * derived from them, kept between box matrix rebuilds.
+ *
+ * Whether two boxes touch only depends on their coordinates, so that test
+ * is repeated only for boxes which moved. When links change (e.g. because a
+ * script made a box invisible), only the rows of boxes in the affected
+ * groups of connected boxes are recomputed. The rows of a group never
+ * depend on boxes outside of it, so the result is identical to computing
+ * the whole matrix from scratch.
+ */
+class BoxGraph {
+public:
+	BoxGraph();
+
+	/** Forget everything, forcing a full rebuild on the next update. */
+	void reset();
+
+	/**
+	 * Prepare an update for a room with 'num' boxes. If the number of boxes
+	 * changed, all cached data is dropped.
+	 */
+	void begin(int num);
+
+	/**
+	 * Record the coordinates of a box. Returns true if they differ from the
+	 * ones seen last time, in which case the caller must redo the touch
+	 * tests involving this box.
+	 */
+	bool setCoords(int box, const BoxCoords &coords);
+
+	bool isTouching(int box1, int box2) const { return _touching[box1 * _numBoxes + box2] != 0; }
+	void setTouching(int box1, int box2, bool touching) { _touching[box1 * _numBoxes + box2] = touching; }
+
+	/** Set whether an actor can walk directly from 'box1' to 'box2'. */
+	void setLink(int box1, int box2, bool linked);
+
+	/** Recompute the itinerary rows invalidated by link changes. */
+	void update();
+
+	/**
+	 * Return the box adjacent to 'from' which is the next one on the
+	 * shortest way to 'to', or Actor::kInvalidBox if there is none.
+	 */
+	byte getItinerary(int from, int to) const { return _itinerary[from * _numBoxes + to]; }
+
+	int getNumBoxes() const { return _numBoxes; }
+
+private:
+	void updateGroup(const Common::Array<int> &group);
+
+	int _numBoxes;
+	Common::Array<BoxCoords> _coords;
+	Common::Array<bool> _coordsValid;
+	Common::Array<byte> _touching;
+	Common::Array<byte> _links;
+	Common::Array<byte> _itinerary;
+	Common::Array<byte> _distances;
+	Common::Array<bool> _dirty;
+};
+
 } // End of namespace Scumm
 
 #endif
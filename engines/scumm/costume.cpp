@@ -73,7 +73,7 @@ static const int v1MMNESLookup[25] = {
 };
 
 byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
-	int i, skip = 0;
+	int i, skip = 0, skipCols = 0;
 	byte drawFlag = 1;
 	bool use_scaling;
 	byte startScaleIndexX;
@@ -236,7 +236,7 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 		if (skip > 0) {
 			if (!newAmiCost && !pcEngCost && _loaded._format != 0x57) {
 				v1.skip_width -= skip;
-				codec1_ignorePakCols(v1, skip);
+				skipCols = skip;
 				v1.x = 0;
 			}
 		} else {
@@ -253,7 +253,7 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 		if (skip > 0) {
 			if (!newAmiCost && !pcEngCost && _loaded._format != 0x57) {
 				v1.skip_width -= skip;
-				codec1_ignorePakCols(v1, skip);
+				skipCols = skip;
 				v1.x = _out.w - 1;
 			}
 		} else {
@@ -305,8 +305,23 @@ byte ClassicCostumeRenderer::mainRoutine(int xmoveCur, int ymoveCur) {
 		proc3_ami(v1);
 	else if (pcEngCost)
 		procPCEngine(v1);
-	else
+	else if (_vm->_costumeFrameCache) {
+		// Draw from the decoded (and, if needed, pre-scaled) frame instead
+		// of decoding the RLE data again.
+		CostumeFrameCache *cache = _vm->_costumeFrameCache;
+		CostumeFrameCache::Key key(_loaded._id, _srcptr - _loaded._baseptr, CostumeFrameCache::kCodec1, v1.shr, _width, _height);
+		const CostumeFrameCache::Frame *frame = cache->getCodec1Frame(key, _srcptr, v1.mask);
+		if (use_scaling) {
+			frame = cache->getScaledCodec1Frame(key, *frame, v1.scaletable, CostumeFrameCache::kScaleTableClassic,
+				_scaleX, _scaleY, _scaleIndexX, _scaleIndexY, v1.scaleXstep, skipCols, v1.skip_width, false);
+			skipCols = 0;
+		}
+		proc3Cached(v1, *frame, skipCols);
+	} else {
+		if (skipCols)
+			codec1_ignorePakCols(v1, skipCols);
 		proc3(v1);
+	}
 
 	return drawFlag;
 }
@@ -518,6 +533,57 @@ void ClassicCostumeRenderer::proc3(Codec1 &v1) {
 	} while (1);
 }
 
+void ClassicCostumeRenderer::proc3Cached(Codec1 &v1, const CostumeFrameCache::Frame &frame, int firstCol) {
+	const byte *mask, *src;
+	byte *dst;
+	byte maskbit;
+	int y, row, col;
+	uint color, pcolor;
+	bool masked, clippedX;
+
+	src = frame.pixels + firstCol * frame.height;
+	col = 0;
+
+	do {
+		y = v1.y;
+		dst = v1.destptr;
+		maskbit = revBitMask(v1.x & 7);
+		mask = v1.mask_ptr + v1.x / 8;
+		clippedX = (v1.x < 0 || v1.x >= _out.w);
+
+		for (row = 0; row < frame.height; row++) {
+			color = src[row];
+			masked = (y < 0 || y >= _out.h) || clippedX || (v1.mask_ptr && (mask[0] & maskbit));
+
+			if (color && !masked) {
+				if (_shadow_mode & 0x20) {
+					pcolor = _shadow_table[*dst];
+				} else {
+					pcolor = _palette[color];
+					if (pcolor == 13 && _shadow_table)
+						pcolor = _shadow_table[*dst];
+				}
+				*dst = pcolor;
+			}
+			dst += _out.pitch;
+			mask += _numStrips;
+			y++;
+		}
+
+		if (!--v1.skip_width)
+			return;
+
+		if (!frame.advance || frame.advance[col]) {
+			v1.x += v1.scaleXstep;
+			if (v1.x < 0 || v1.x >= _out.w)
+				return;
+			v1.destptr += v1.scaleXstep;
+		}
+		src += frame.height;
+		col++;
+	} while (1);
+}
+
 void ClassicCostumeRenderer::proc3_ami(Codec1 &v1) {
 	const byte *mask, *src;
 	byte *dst;
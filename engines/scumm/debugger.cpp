@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "common/debug-channels.h"
 #include "common/file.h"
 #include "common/str.h"
@@ -78,6 +79,7 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	DCmd_Register("script",    WRAP_METHOD(ScummDebugger, Cmd_Script));
 	DCmd_Register("scr",       WRAP_METHOD(ScummDebugger, Cmd_Script));
 	DCmd_Register("scripts",   WRAP_METHOD(ScummDebugger, Cmd_PrintScript));
+	DCmd_Register("opcodes",   WRAP_METHOD(ScummDebugger, Cmd_Opcodes));
 	DCmd_Register("importres", WRAP_METHOD(ScummDebugger, Cmd_ImportRes));
 
 	if (_vm->_game.id == GID_LOOM)
@@ -330,6 +332,52 @@ bool ScummDebugger::Cmd_PrintScript(int argc, const char **argv) {
 	return true;
 }
 
+struct OpcodeCountGreater {
+	const uint32 *_counts;
+	OpcodeCountGreater(const uint32 *counts) : _counts(counts) {}
+	bool operator()(int a, int b) const { return _counts[a] > _counts[b]; }
+};
+
+bool ScummDebugger::Cmd_Opcodes(int argc, const char **argv) {
+	if (argc > 1) {
+		if (!strcmp(argv[1], "on")) {
+			_vm->_profileOpcodes = true;
+			DebugPrintf("Opcode profiling enabled\n");
+			return true;
+		} else if (!strcmp(argv[1], "off")) {
+			_vm->_profileOpcodes = false;
+			DebugPrintf("Opcode profiling disabled\n");
+			return true;
+		} else if (!strcmp(argv[1], "reset")) {
+			memset(_vm->_opcodeCounts, 0, sizeof(_vm->_opcodeCounts));
+			DebugPrintf("Opcode counters cleared\n");
+			return true;
+		} else if (Common::isDigit(argv[1][0])) {
+			// Print the report, limited to the given number of opcodes
+		} else {
+			DebugPrintf("Syntax: opcodes [on | off | reset | <count>]\n");
+			return true;
+		}
+	}
+
+	int order[256];
+	uint32 total = 0;
+	for (int i = 0; i < 256; i++) {
+		order[i] = i;
+		total += _vm->_opcodeCounts[i];
+	}
+	Common::sort(order, order + 256, OpcodeCountGreater(_vm->_opcodeCounts));
+
+	int limit = (argc > 1) ? atoi(argv[1]) : 20;
+	DebugPrintf("Opcode profiling is %s, %u opcodes executed\n", _vm->_profileOpcodes ? "on" : "off", total);
+	for (int i = 0; i < limit && i < 256 && _vm->_opcodeCounts[order[i]]; i++) {
+		const int op = order[i];
+		DebugPrintf("  [%02X] %-30s %10u  %5.1f%%\n", op, _vm->getOpcodeDesc(op),
+				_vm->_opcodeCounts[op], 100.0 * _vm->_opcodeCounts[op] / total);
+	}
+	return true;
+}
+
 bool ScummDebugger::Cmd_Actor(int argc, const char **argv) {
 	Actor *a;
 	int actnum;
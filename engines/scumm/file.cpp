@@ -184,6 +184,17 @@ uint32 ScummFile::read(void *dataPtr, uint32 dataSize) {
 	return realLen;
 }
 
+const byte *ScummFile::peekPointer(uint32 dataSize) {
+	// Encrypted data has to go through read()
+	if (_encbyte)
+		return 0;
+
+	if (_subFileLen && (int32)dataSize > _subFileLen - pos())
+		return 0;
+
+	return File::peekPointer(dataSize);
+}
+
 #pragma mark -
 #pragma mark --- ScummDiskImage ---
 #pragma mark -
@@ -45,6 +45,9 @@ public:
 	virtual int32 size() const = 0;
 	virtual bool seek(int32 offs, int whence = SEEK_SET) = 0;
 
+	/** Data which read() has to decode cannot be accessed directly. */
+	virtual const byte *peekPointer(uint32 dataSize) { return 0; }
+
 // Unused
 #if 0
 	virtual bool eos() const = 0;
@@ -74,6 +77,7 @@ public:
 	int32 size() const;
 	bool seek(int32 offs, int whence = SEEK_SET);
 	uint32 read(void *dataPtr, uint32 dataSize);
+	const byte *peekPointer(uint32 dataSize);
 };
 
 class ScummDiskImage : public BaseScummFile {
@@ -202,6 +202,8 @@ protected:
 
 	virtual void clearDrawQueues();
 
+	virtual void resourceNuked(ResType type, ResId idx);
+
 	int getStringCharWidth(byte chr);
 	void appendSubstring(int dst, int src, int len2, int len);
 	void adjustRect(Common::Rect &rect);
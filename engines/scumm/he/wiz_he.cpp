@@ -625,6 +625,28 @@ void Wiz::copyWizImageWithMask(uint8 *dst, const uint8 *src, int dstPitch, int d
 	}
 }
 
+void Wiz::copyDecodedWizImage(uint8 *dst, const WizDecodedImage &img, int dstPitch, int dstType, int dstw, int dsth, int srcx, int srcy, const Common::Rect *rect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+	Common::Rect r1, r2;
+	if (calcClipRects(dstw, dsth, srcx, srcy, img.width, img.height, rect, r1, r2)) {
+		dst += r2.top * dstPitch + r2.left * bitDepth;
+		if (flags & kWIFFlipY) {
+			const int dy = (srcy < 0) ? srcy : (img.height - r1.height());
+			r1.translate(0, dy);
+		}
+		if (flags & kWIFFlipX) {
+			const int dx = (srcx < 0) ? srcx : (img.width - r1.width());
+			r1.translate(dx, 0);
+		}
+		if (xmapPtr) {
+			drawDecodedWizImage<kWizXMap>(dst, dstPitch, dstType, img, r1, flags, palPtr, xmapPtr, bitDepth);
+		} else if (palPtr && img.bitDepth == 1) {
+			drawDecodedWizImage<kWizRMap>(dst, dstPitch, dstType, img, r1, flags, palPtr, NULL, bitDepth);
+		} else {
+			drawDecodedWizImage<kWizCopy>(dst, dstPitch, dstType, img, r1, flags, NULL, NULL, bitDepth);
+		}
+	}
+}
+
 #ifdef USE_RGB_COLOR
 void Wiz::copyRaw16BitWizImage(uint8 *dst, const uint8 *src, int dstPitch, int dstType, int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int flags, int transColor) {
 	Common::Rect r1, r2;
@@ -976,6 +998,204 @@ void Wiz::decompressRawWizImage(uint8 *dst, int dstPitch, int dstType, const uin
 	}
 }
 
+template<int type>
+void Wiz::drawDecodedWizImage(uint8 *dst, int dstPitch, int dstType, const WizDecodedImage &img, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+	uint8 *dstPtr;
+	int h, w, dstInc;
+
+	if (type == kWizXMap) {
+		assert(xmapPtr != 0);
+	}
+	if (type == kWizRMap) {
+		assert(palPtr != 0);
+	}
+
+	h = srcRect.height();
+	w = srcRect.width();
+	if (h <= 0 || w <= 0)
+		return;
+
+	dstPtr = dst;
+	if (flags & kWIFFlipY) {
+		dstPtr += (h - 1) * dstPitch;
+		dstPitch = -dstPitch;
+	}
+	dstInc = bitDepth;
+	if (flags & kWIFFlipX) {
+		dstPtr += (w - 1) * bitDepth;
+		dstInc = -bitDepth;
+	}
+
+	const uint8 *pixels = img.pixels.begin();
+	const WizDecodedImage::Span *spans = img.spans.begin();
+
+	for (int y = srcRect.top; y < srcRect.bottom; y++, dstPtr += dstPitch) {
+		if (y < 0 || y >= img.height)
+			continue;
+
+		// Only the opaque spans of each line are visited, and all of them
+		// are straight copies without any RLE codes to interpret.
+		for (uint32 i = img.lines[y]; i < img.lines[y + 1]; i++) {
+			const WizDecodedImage::Span &span = spans[i];
+			const int x1 = MAX<int>(span.x, srcRect.left);
+			const int x2 = MIN<int>(span.x + span.len, srcRect.right);
+			if (x1 >= x2)
+				continue;
+
+			const uint8 *src = pixels + span.offset + (x1 - span.x) * img.bitDepth;
+			uint8 *d = dstPtr + (x1 - srcRect.left) * dstInc;
+			int n = x2 - x1;
+
+			if (img.bitDepth == 2) {
+#ifdef USE_RGB_COLOR
+				while (n--) {
+					write16BitColor<type>(d, src, dstType, xmapPtr);
+					src += 2;
+					d += dstInc;
+				}
+#endif
+			} else if (bitDepth == 1 && type == kWizCopy && dstInc == 1) {
+				memcpy(d, src, n);
+			} else if (bitDepth == 1 && type == kWizRMap) {
+				while (n--) {
+					*d = palPtr[*src++];
+					d += dstInc;
+				}
+			} else {
+				while (n--) {
+					write8BitColor<type>(d, src, dstType, palPtr, xmapPtr, bitDepth);
+					src++;
+					d += dstInc;
+				}
+			}
+		}
+	}
+}
+
+void WizDecodedImage::decode(const uint8 *src, int w, int h, uint8 depth) {
+	width = w;
+	height = h;
+	bitDepth = depth;
+	wizd = src;
+
+	lines.clear();
+	spans.clear();
+	pixels.clear();
+	lines.reserve(h + 1);
+
+	for (int y = 0; y < h; y++) {
+		lines.push_back(spans.size());
+
+		uint16 lineSize = READ_LE_UINT16(src); src += 2;
+		const uint8 *srcNext = src + lineSize;
+		int x = 0;
+		while (lineSize != 0 && x < w && src < srcNext) {
+			uint8 code = *src++;
+			if (code & 1) {
+				// Transparent run
+				x += code >> 1;
+				continue;
+			}
+
+			int len = (code >> 2) + 1;
+			if (len > w - x)
+				len = w - x;
+
+			// Append to the previous span if they touch
+			if (spans.size() > lines[y] && spans.back().x + spans.back().len == x) {
+				spans.back().len += len;
+			} else {
+				Span span;
+				span.x = x;
+				span.len = len;
+				span.offset = pixels.size();
+				spans.push_back(span);
+			}
+
+			if (code & 2) {
+				// Single color run
+				for (int i = 0; i < len; i++)
+					for (int j = 0; j < depth; j++)
+						pixels.push_back(src[j]);
+				src += depth;
+			} else {
+				// Literal run
+				for (int i = 0; i < len * depth; i++)
+					pixels.push_back(src[i]);
+				src += ((code >> 2) + 1) * depth;
+			}
+			x += len;
+		}
+		src = srcNext;
+	}
+	lines.push_back(spans.size());
+}
+
+uint32 WizDecodedImage::size() const {
+	return sizeof(WizDecodedImage) + lines.size() * sizeof(uint32) + spans.size() * sizeof(Span) + pixels.size();
+}
+
+WizDecodeCache::WizDecodeCache(uint32 memoryBudget) : _memoryBudget(memoryBudget), _memoryUsage(0) {
+}
+
+WizDecodeCache::~WizDecodeCache() {
+	clear();
+}
+
+const WizDecodedImage *WizDecodeCache::get(int resNum, int state, const uint8 *wizd, int width, int height, uint8 bitDepth) {
+	const uint32 key = (resNum << 16) | (state & 0xFFFF);
+
+	Common::HashMap<uint32, Entry *>::iterator i = _entries.find(key);
+	if (i != _entries.end()) {
+		Entry *entry = i->_value;
+		const WizDecodedImage &img = entry->image;
+		if (img.wizd == wizd && img.width == width && img.height == height && img.bitDepth == bitDepth) {
+			_lru.erase(entry->lru);
+			_lru.push_front(entry);
+			entry->lru = _lru.begin();
+			return &entry->image;
+		}
+		remove(entry);
+	}
+
+	Entry *entry = new Entry;
+	entry->key = key;
+	entry->image.decode(wizd, width, height, bitDepth);
+	entry->size = entry->image.size();
+
+	while (!_lru.empty() && _memoryUsage + entry->size > _memoryBudget)
+		remove(_lru.back());
+
+	_lru.push_front(entry);
+	entry->lru = _lru.begin();
+	_entries[key] = entry;
+	_memoryUsage += entry->size;
+
+	return &entry->image;
+}
+
+void WizDecodeCache::remove(Entry *entry) {
+	_entries.erase(entry->key);
+	_lru.erase(entry->lru);
+	_memoryUsage -= entry->size;
+	delete entry;
+}
+
+void WizDecodeCache::invalidate(int resNum) {
+	Common::List<Entry *>::iterator i = _lru.begin();
+	while (i != _lru.end()) {
+		Entry *entry = *i;
+		++i;
+		if ((int)(entry->key >> 16) == resNum)
+			remove(entry);
+	}
+}
+
+void WizDecodeCache::clear() {
+	while (!_lru.empty())
+		remove(_lru.front());
+}
+
 int Wiz::isWizPixelNonTransparent(const uint8 *data, int x, int y, int w, int h, uint8 bitDepth) {
 	if (x < 0 || x >= w || y < 0 || y >= h) {
 		return 0;
@@ -1588,7 +1808,8 @@ uint8 *Wiz::drawWizImage(int resNum, int state, int maskNum, int maskState, int
 			dstPitch /= _vm->_bytesPerPixel;
 			copyWizImageWithMask(dst, wizd, dstPitch, cw, ch, x1, y1, width, height, &rScreen, 0, 1);
 		} else {
-			copyWizImage(dst, wizd, dstPitch, dstType, cw, ch, x1, y1, width, height, &rScreen, flags, palPtr, xmapPtr, _vm->_bytesPerPixel);
+			const WizDecodedImage *img = _decodeCache.get(resNum, state, wizd, width, height, 1);
+			copyDecodedWizImage(dst, *img, dstPitch, dstType, cw, ch, x1, y1, &rScreen, flags, palPtr, xmapPtr, _vm->_bytesPerPixel);
 		}
 		break;
 #ifdef USE_RGB_COLOR
@@ -1602,8 +1823,10 @@ uint8 *Wiz::drawWizImage(int resNum, int state, int maskNum, int maskState, int
 	case 4:
 		// TODO: Unknown image type
 		break;
-	case 5:
-		copy16BitWizImage(dst, wizd, dstPitch, dstType, cw, ch, x1, y1, width, height, &rScreen, flags, xmapPtr);
+	case 5: {
+		const WizDecodedImage *img = _decodeCache.get(resNum, state, wizd, width, height, 2);
+		copyDecodedWizImage(dst, *img, dstPitch, dstType, cw, ch, x1, y1, &rScreen, flags, NULL, xmapPtr, 2);
+		}
 		break;
 #endif
 	default:
@@ -2704,6 +2927,14 @@ int ScummEngine_v90he::computeWizHistogram(int resNum, int state, int x, int y,
 	return readVar(0);
 }
 
+void ScummEngine_v71he::resourceNuked(ResType type, ResId idx) {
+	ScummEngine_v70he::resourceNuked(type, idx);
+
+	// Decoded images of this resource are stale now
+	if (type == rtImage && _wiz)
+		_wiz->_decodeCache.invalidate(idx);
+}
+
 } // End of namespace Scumm
 
 #endif // ENABLE_HE
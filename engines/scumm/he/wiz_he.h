@@ -23,6 +23,9 @@
 #if !defined(SCUMM_HE_WIZ_HE_H) && defined(ENABLE_HE)
 #define SCUMM_HE_WIZ_HE_H
 
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/list.h"
 #include "common/rect.h"
 
 namespace Scumm {
@@ -148,6 +151,69 @@ enum DstSurface {
 
 class ScummEngine_v71he;
 
+/**
+ * A compressed (type 1 or 5) Wiz image with its RLE encoding undone: the
+ * opaque runs ("spans") of each line, pointing into the decoded pixels.
+ * Pixels keep the source format, i.e. palette indices for type 1 and
+ * little endian 16-bit colors for type 5.
+ */
+struct WizDecodedImage {
+	struct Span {
+		uint16 x, len;
+		uint32 offset;
+	};
+
+	int width, height;
+	uint8 bitDepth;
+	const uint8 *wizd;
+
+	/** Index of the first span of each line, plus an end marker */
+	Common::Array<uint32> lines;
+	Common::Array<Span> spans;
+	Common::Array<uint8> pixels;
+
+	void decode(const uint8 *src, int w, int h, uint8 depth);
+	uint32 size() const;
+};
+
+/**
+ * Cache of decoded Wiz images, keyed by resource and state. The least
+ * recently used images are dropped when the memory budget is exceeded.
+ */
+class WizDecodeCache {
+public:
+	enum {
+		kDefaultMemoryBudget = 8 * 1024 * 1024
+	};
+
+	WizDecodeCache(uint32 memoryBudget = kDefaultMemoryBudget);
+	~WizDecodeCache();
+
+	/** Return the decoded image, decoding the WIZD data if it's not cached. */
+	const WizDecodedImage *get(int resNum, int state, const uint8 *wizd, int width, int height, uint8 bitDepth);
+
+	/** Drop all states of the given image resource. */
+	void invalidate(int resNum);
+	void clear();
+
+	uint32 getMemoryUsage() const { return _memoryUsage; }
+
+private:
+	struct Entry {
+		uint32 key;
+		WizDecodedImage image;
+		uint32 size;
+		Common::List<Entry *>::iterator lru;
+	};
+
+	void remove(Entry *entry);
+
+	Common::HashMap<uint32, Entry *> _entries;
+	Common::List<Entry *> _lru;
+	uint32 _memoryBudget;
+	uint32 _memoryUsage;
+};
+
 class Wiz {
 public:
 	enum {
@@ -224,6 +290,9 @@ public:
 	template<int type> static void decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitdepth);
 	template<int type> static void decompressRawWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, int srcPitch, int w, int h, int transColor, const uint8 *palPtr, uint8 bitdepth);
 
+	static void copyDecodedWizImage(uint8 *dst, const WizDecodedImage &img, int dstPitch, int dstType, int dstw, int dsth, int srcx, int srcy, const Common::Rect *rect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth);
+	template<int type> static void drawDecodedWizImage(uint8 *dst, int dstPitch, int dstType, const WizDecodedImage &img, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth);
+
 #ifdef USE_RGB_COLOR
 	template<int type> static void write16BitColor(uint8 *dst, const uint8 *src, int dstType, const uint8 *xmapPtr);
 #endif
@@ -236,6 +305,8 @@ public:
 	void computeWizHistogram(uint32 *histogram, const uint8 *data, const Common::Rect& rCapt);
 	void computeRawWizHistogram(uint32 *histogram, const uint8 *data, int srcPitch, const Common::Rect& rCapt);
 
+	WizDecodeCache _decodeCache;
+
 private:
 	ScummEngine_v71he *_vm;
 };
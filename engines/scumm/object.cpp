@@ -1733,6 +1733,8 @@ void ScummEngine_v6::drawBlastObject(BlastObject *eo) {
 		bdd.srcheight = READ_LE_UINT16(bomp+4);
 	}
 
+	bdd.decoded = 0;
+
 	bdd.scale_x = (byte)eo->scaleX;
 	bdd.scale_y = (byte)eo->scaleY;
 
@@ -25,6 +25,7 @@
 #include "common/config-manager.h"
 #endif
 
+#include "scumm/base-costume.h"
 #include "scumm/charset.h"
 #include "scumm/dialogs.h"
 #include "scumm/file.h"
@@ -498,12 +499,17 @@ int ScummEngine::readResTypeList(ResType type) {
 
 	debug(2, "  readResTypeList(%s): %d entries", nameOfResType(type), num);
 
+	// Fetch the room numbers and offsets in one go, instead of with a read
+	// call per entry
+	Common::StreamSpan list;
+	if (!_fileHandle->readSpan(num * 5, list))
+		error("Truncated %s directory", nameOfResType(type));
 
+	const byte *roomNumbers = list.data();
+	const byte *roomOffsets = list.data() + num;
 	for (idx = 0; idx < num; idx++) {
-		_res->_types[type][idx]._roomno = _fileHandle->readByte();
-	}
-	for (idx = 0; idx < num; idx++) {
-		_res->_types[type][idx]._roomoffs = _fileHandle->readUint32LE();
+		_res->_types[type][idx]._roomno = roomNumbers[idx];
+		_res->_types[type][idx]._roomoffs = READ_LE_UINT32(roomOffsets + idx * 4);
 	}
 
 	return num;
@@ -899,6 +905,8 @@ void ResourceManager::nukeResource(ResType type, ResId idx) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
 		_allocatedSize -= _types[type][idx]._size;
 		_types[type][idx].nuke();
+
+		_vm->resourceNuked(type, idx);
 	}
 }
 
@@ -988,6 +996,12 @@ bool ScummEngine::isResourceInUse(ResType type, ResId idx) const {
 	}
 }
 
+void ScummEngine::resourceNuked(ResType type, ResId idx) {
+	// Decoded frames of this costume are stale now
+	if (type == rtCostume && _costumeFrameCache)
+		_costumeFrameCache->invalidate(idx);
+}
+
 void ResourceManager::setModified(ResType type, ResId idx) {
 	if (!validateResource("Modified", type, idx))
 		return;
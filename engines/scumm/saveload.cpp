@@ -172,8 +172,12 @@ bool ScummEngine::saveState(Common::OutSaveFile *out, bool writeHeader) {
 #endif
 	saveInfos(out);
 
-	Serializer ser(0, out, CURRENT_VER);
+	SaveChunkWriter chunks(out, *_saveChunkCache);
+	Serializer ser(0, &chunks, CURRENT_VER);
+	ser.setChunkWriter(&chunks);
 	saveOrLoad(&ser);
+	ser.flush();
+	chunks.finish();
 	return true;
 }
 
@@ -190,7 +194,8 @@ bool ScummEngine::saveState(int slot, bool compat) {
 	} else {
 		filename = makeSavegameName(slot, compat);
 	}
-	if (!(out = _saveFileMan->openForSaving(filename)))
+	// The savegame data is compressed in blocks, see SaveChunkWriter
+	if (!(out = _saveFileMan->openForSaving(filename, false)))
 		return false;
 
 	saveFailed = false;
@@ -257,7 +262,7 @@ bool ScummEngine_v4::savePreparedSavegame(int slot, char *desc) {
 	// open savegame file
 	if (success) {
 		filename = makeSavegameName(slot, false);
-		if (!(out = _saveFileMan->openForSaving(filename))) {
+		if (!(out = _saveFileMan->openForSaving(filename, false))) {
 			success = false;
 		}
 	}
@@ -438,7 +443,9 @@ bool ScummEngine::loadState(int slot, bool compat) {
 	//
 	// Now do the actual loading
 	//
-	Serializer ser(in, 0, hdr.ver);
+	// Since version 95 the data is stored in separately compressed blocks
+	SaveChunkReader chunks(in);
+	Serializer ser(hdr.ver >= VER(95) ? (Common::ReadStream *)&chunks : in, 0, hdr.ver);
 	saveOrLoad(&ser);
 	delete in;
 
@@ -1249,6 +1256,7 @@ void ScummEngine::saveOrLoad(Serializer *s) {
 					for (idx = 0; idx < _res->_types[type].size(); idx++) {
 						// Only save resources which actually exist...
 						if (_res->_types[type][idx]._address) {
+							s->startChunk((type << 16) | idx);
 							s->saveUint16(idx);	// Save the index of the resource
 							saveResource(s, type, idx);
 						}
@@ -1285,6 +1293,7 @@ void ScummEngine::saveOrLoad(Serializer *s) {
 	//
 	// Save/load global object state
 	//
+	s->startChunk(MKTAG('O','B','J','S'));
 	s->saveLoadArrayOf(_objectOwnerTable, _numGlobalObjects, sizeof(_objectOwnerTable[0]), sleByte);
 	s->saveLoadArrayOf(_objectStateTable, _numGlobalObjects, sizeof(_objectStateTable[0]), sleByte);
 	if (_objectRoomTable)
@@ -1413,6 +1422,7 @@ void ScummEngine::saveOrLoad(Serializer *s) {
 	//
 	// Save/load script variables
 	//
+	s->startChunk(MKTAG('V','A','R','S'));
 	var120Backup = _scummVars[120];
 	var98Backup = _scummVars[98];
 
@@ -1431,6 +1441,7 @@ void ScummEngine::saveOrLoad(Serializer *s) {
 		_scummVars[98] = var98Backup;
 
 	s->saveLoadArrayOf(_bitVars, _numBitVariables >> 3, 1, sleByte);
+	s->startChunk(MKTAG('M','I','S','C'));
 
 
 	//
@@ -1781,36 +1792,284 @@ void ScummEngine::loadResource(Serializer *ser, ResType type, ResId idx) {
 	}
 }
 
+void SaveChunkCache::freeBlocks(ChunkMap &chunks) {
+	for (ChunkMap::iterator i = chunks.begin(); i != chunks.end(); ++i) {
+		for (uint j = 0; j < i->_value.size(); j++) {
+			free(i->_value[j].data);
+			free(i->_value[j].packed);
+		}
+	}
+	chunks.clear();
+}
+
+void SaveChunkCache::clear() {
+	freeBlocks(_chunks);
+}
+
+SaveChunkWriter::SaveChunkWriter(Common::WriteStream *out, SaveChunkCache &cache)
+	: _out(out), _cache(cache), _chunkId(0), _blockSize(0) {
+	_block = (byte *)malloc(kSaveBlockSize);
+}
+
+SaveChunkWriter::~SaveChunkWriter() {
+	// Only set if finish() was not called
+	SaveChunkCache::freeBlocks(_newChunks);
+	free(_block);
+}
+
+void SaveChunkWriter::startChunk(uint32 id) {
+	writeBlock();
+	_chunkId = id;
+}
+
+void SaveChunkWriter::finish() {
+	writeBlock();
+	_out->writeUint32LE(0);
+
+	// Blocks which were reused have been taken out of the old cache
+	SaveChunkCache::freeBlocks(_cache._chunks);
+	_cache._chunks = _newChunks;
+	_newChunks.clear();
+}
+
+uint32 SaveChunkWriter::write(const void *dataPtr, uint32 dataSize) {
+	const byte *src = (const byte *)dataPtr;
+	uint32 left = dataSize;
+	while (left) {
+		if (_blockSize == kSaveBlockSize)
+			writeBlock();
+		const uint32 n = MIN<uint32>(left, kSaveBlockSize - _blockSize);
+		memcpy(_block + _blockSize, src, n);
+		_blockSize += n;
+		src += n;
+		left -= n;
+	}
+	return dataSize;
+}
+
+void SaveChunkWriter::writeBlock() {
+	if (!_blockSize)
+		return;
+
+	SaveChunkCache::BlockList &blocks = _newChunks[_chunkId];
+	SaveChunkCache::Block block;
+	block.data = 0;
+
+	// Reuse the compressed data of the same block in the previous savegame
+	// if it did not change
+	SaveChunkCache::ChunkMap::iterator old = _cache._chunks.find(_chunkId);
+	if (old != _cache._chunks.end() && blocks.size() < old->_value.size()) {
+		SaveChunkCache::Block &oldBlock = old->_value[blocks.size()];
+		if (oldBlock.data && oldBlock.size == _blockSize && !memcmp(oldBlock.data, _block, _blockSize)) {
+			block = oldBlock;
+			oldBlock.data = oldBlock.packed = 0;
+		}
+	}
+
+	if (!block.data) {
+		block.data = (byte *)malloc(_blockSize);
+		memcpy(block.data, _block, _blockSize);
+		block.size = _blockSize;
+
+		Common::MemoryWriteStreamDynamic *memStream = new Common::MemoryWriteStreamDynamic();
+		Common::WriteStream *writeStream = Common::wrapCompressedWriteStream(memStream);
+		writeStream->write(_block, _blockSize);
+		writeStream->finalize();
+		block.packed = memStream->getData();
+		block.packedSize = memStream->size();
+		delete writeStream;
+
+		// Without zlib, or for incompressible data
+		if (block.packedSize >= _blockSize) {
+			free(block.packed);
+			block.packed = 0;
+			block.packedSize = 0;
+		}
+	}
+
+	_out->writeUint32LE(block.size);
+	_out->writeUint32LE(block.packedSize);
+	if (block.packed)
+		_out->write(block.packed, block.packedSize);
+	else
+		_out->write(block.data, block.size);
+
+	blocks.push_back(block);
+	_blockSize = 0;
+}
+
+SaveChunkReader::SaveChunkReader(Common::ReadStream *in)
+	: _in(in), _block(0), _blockPos(0), _blockSize(0), _eos(false), _err(false) {
+}
+
+SaveChunkReader::~SaveChunkReader() {
+	free(_block);
+}
+
+bool SaveChunkReader::readBlock() {
+	_blockPos = _blockSize = 0;
+
+	const uint32 size = _in->readUint32LE();
+	const uint32 packedSize = _in->readUint32LE();
+	if (_in->err() || _in->eos() || !size) {
+		_eos = true;
+		return false;
+	}
+	if (size > kSaveBlockSize) {
+		_err = true;
+		return false;
+	}
+
+	if (!_block)
+		_block = (byte *)malloc(kSaveBlockSize);
+
+	if (!packedSize) {
+		_blockSize = _in->read(_block, size);
+	} else {
+		byte *packed = (byte *)malloc(packedSize);
+		if (_in->read(packed, packedSize) == packedSize) {
+			Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(
+				new Common::MemoryReadStream(packed, packedSize, DisposeAfterUse::YES), size);
+			if (stream) {
+				_blockSize = stream->read(_block, size);
+				delete stream;
+			}
+		} else {
+			free(packed);
+		}
+	}
+
+	if (_blockSize != size) {
+		_err = true;
+		return false;
+	}
+	return true;
+}
+
+uint32 SaveChunkReader::read(void *dataPtr, uint32 dataSize) {
+	byte *dst = (byte *)dataPtr;
+	uint32 left = dataSize;
+	while (left) {
+		if (_blockPos == _blockSize && (_eos || _err || !readBlock()))
+			break;
+		const uint32 n = MIN(left, _blockSize - _blockPos);
+		memcpy(dst, _block + _blockPos, n);
+		_blockPos += n;
+		dst += n;
+		left -= n;
+	}
+	return dataSize - left;
+}
+
+void Serializer::flush() {
+	if (_saveStream && _bufferPos) {
+		_saveStream->write(_buffer, _bufferPos);
+		_bufferPos = 0;
+	}
+}
+
+void Serializer::startChunk(uint32 id) {
+	if (_chunkWriter) {
+		flush();
+		_chunkWriter->startChunk(id);
+	}
+}
+
+void Serializer::fillBuffer() {
+	// Keep what has not been consumed yet
+	_bufferSize -= _bufferPos;
+	memmove(_buffer, _buffer + _bufferPos, _bufferSize);
+	_bufferPos = 0;
+	_bufferSize += _loadStream->read(_buffer + _bufferSize, kBufferSize - _bufferSize);
+}
+
 void Serializer::saveBytes(void *b, int len) {
-	_saveStream->write(b, len);
+	if (_bufferPos + len > kBufferSize) {
+		flush();
+		if (len >= kBufferSize) {
+			_saveStream->write(b, len);
+			return;
+		}
+	}
+	memcpy(_buffer + _bufferPos, b, len);
+	_bufferPos += len;
 }
 
 void Serializer::loadBytes(void *b, int len) {
-	_loadStream->read(b, len);
+	byte *dst = (byte *)b;
+	uint32 avail = _bufferSize - _bufferPos;
+
+	if ((uint32)len > avail) {
+		// Use up the buffer, then read large blocks directly
+		memcpy(dst, _buffer + _bufferPos, avail);
+		dst += avail;
+		len -= avail;
+		_bufferPos = _bufferSize = 0;
+		if (len >= kBufferSize) {
+			uint32 got = _loadStream->read(dst, len);
+			if (got < (uint32)len)
+				memset(dst + got, 0, len - got);
+			return;
+		}
+		fillBuffer();
+		if ((uint32)len > _bufferSize) {
+			memset(dst + _bufferSize, 0, len - _bufferSize);
+			len = _bufferSize;
+		}
+	}
+	memcpy(dst, _buffer + _bufferPos, len);
+	_bufferPos += len;
 }
 
 void Serializer::saveUint32(uint32 d) {
-	_saveStream->writeUint32LE(d);
+	if (_bufferPos + 4 > kBufferSize)
+		flush();
+	WRITE_LE_UINT32(_buffer + _bufferPos, d);
+	_bufferPos += 4;
 }
 
 void Serializer::saveUint16(uint16 d) {
-	_saveStream->writeUint16LE(d);
+	if (_bufferPos + 2 > kBufferSize)
+		flush();
+	WRITE_LE_UINT16(_buffer + _bufferPos, d);
+	_bufferPos += 2;
 }
 
 void Serializer::saveByte(byte b) {
-	_saveStream->writeByte(b);
+	if (_bufferPos + 1 > kBufferSize)
+		flush();
+	_buffer[_bufferPos++] = b;
 }
 
 uint32 Serializer::loadUint32() {
-	return _loadStream->readUint32LE();
+	if (_bufferPos + 4 > _bufferSize) {
+		byte data[4];
+		loadBytes(data, 4);
+		return READ_LE_UINT32(data);
+	}
+	uint32 d = READ_LE_UINT32(_buffer + _bufferPos);
+	_bufferPos += 4;
+	return d;
 }
 
 uint16 Serializer::loadUint16() {
-	return _loadStream->readUint16LE();
+	if (_bufferPos + 2 > _bufferSize) {
+		byte data[2];
+		loadBytes(data, 2);
+		return READ_LE_UINT16(data);
+	}
+	uint16 d = READ_LE_UINT16(_buffer + _bufferPos);
+	_bufferPos += 2;
+	return d;
 }
 
 byte Serializer::loadByte() {
-	return _loadStream->readByte();
+	if (_bufferPos >= _bufferSize) {
+		byte data;
+		loadBytes(&data, 1);
+		return data;
+	}
+	return _buffer[_bufferPos++];
 }
 
 void Serializer::saveArrayOf(void *b, int len, int datasize, byte filetype) {
@@ -24,13 +24,11 @@
 #define SCUMM_SAVELOAD_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/stream.h"
 #include <stddef.h>	// for ptrdiff_t
 
-namespace Common {
-class SeekableReadStream;
-class WriteStream;
-}
-
 namespace Scumm {
 
 
@@ -47,7 +45,7 @@ namespace Scumm {
  * only saves/loads those which are valid for the version of the savegame
  * which is being loaded/saved currently.
  */
-#define CURRENT_VER 94
+#define CURRENT_VER 95
 
 /**
  * An auxillary macro, used to specify savegame versions. We use this instead
@@ -120,12 +118,133 @@ struct SaveLoadEntry {
 	uint8 maxVersion;
 };
 
+/**
+ * Since version 95, the data serialized by ScummEngine::saveOrLoad() is
+ * stored as a sequence of blocks, each compressed on its own:
+ *
+ *   uint32LE  size of the data
+ *   uint32LE  size of the compressed data, 0 if it is stored uncompressed
+ *   byte[]    the (compressed) data
+ *
+ * followed by a size of 0. The data is divided into chunks at fixed points
+ * (e.g. for every resource), and chunks into blocks of at most
+ * kSaveBlockSize bytes. Blocks which are identical to the same block of the
+ * previous savegame are not compressed again, so frequent saves only pay
+ * for compressing what changed. The savefile as a whole is not compressed.
+ */
+enum {
+	kSaveBlockSize = 65536
+};
+
+/**
+ * The blocks of the last savegame written, along with their compressed
+ * form. Owned by the engine, so that it survives from one save to the next.
+ */
+class SaveChunkCache {
+public:
+	~SaveChunkCache() { clear(); }
+
+	void clear();
+
+private:
+	friend class SaveChunkWriter;
+
+	struct Block {
+		byte *data;		///< malloc()ed, like the compressed data
+		uint32 size;
+		byte *packed;	///< 0 if the data is stored uncompressed
+		uint32 packedSize;
+	};
+
+	typedef Common::Array<Block> BlockList;
+	typedef Common::HashMap<uint32, BlockList> ChunkMap;
+
+	static void freeBlocks(ChunkMap &chunks);
+
+	ChunkMap _chunks;
+};
+
+/**
+ * Writes serialized data in the block format described above.
+ */
+class SaveChunkWriter : public Common::WriteStream {
+public:
+	SaveChunkWriter(Common::WriteStream *out, SaveChunkCache &cache);
+	~SaveChunkWriter();
+
+	/**
+	 * Start a new chunk. Its blocks are compared against the blocks of the
+	 * chunk with the same id in the previous savegame.
+	 */
+	void startChunk(uint32 id);
+
+	/** Write the last block and the end marker, and update the cache. */
+	void finish();
+
+	uint32 write(const void *dataPtr, uint32 dataSize);
+	bool err() const { return _out->err(); }
+	void clearErr() { _out->clearErr(); }
+
+private:
+	void writeBlock();
+
+	Common::WriteStream *_out;
+	SaveChunkCache &_cache;
+	SaveChunkCache::ChunkMap _newChunks;
+	uint32 _chunkId;
+	byte *_block;
+	uint32 _blockSize;
+};
+
+/**
+ * Reads serialized data from the block format described above. Blocks are
+ * only read and uncompressed when the data is asked for.
+ */
+class SaveChunkReader : public Common::ReadStream {
+public:
+	SaveChunkReader(Common::ReadStream *in);
+	~SaveChunkReader();
+
+	uint32 read(void *dataPtr, uint32 dataSize);
+	bool eos() const { return _eos; }
+	bool err() const { return _err || _in->err(); }
+	void clearErr() { _eos = _err = false; _in->clearErr(); }
+
+private:
+	bool readBlock();
+
+	Common::ReadStream *_in;
+	byte *_block;
+	uint32 _blockPos, _blockSize;
+	bool _eos, _err;
+};
+
 class Serializer {
 public:
-	Serializer(Common::SeekableReadStream *in, Common::WriteStream *out, uint32 savegameVersion)
-		: _loadStream(in), _saveStream(out),
-		  _savegameVersion(savegameVersion)
-	{ }
+	Serializer(Common::ReadStream *in, Common::WriteStream *out, uint32 savegameVersion)
+		: _loadStream(in), _saveStream(out), _chunkWriter(0),
+		  _savegameVersion(savegameVersion),
+		  _bufferPos(0), _bufferSize(0) {
+		_buffer = new byte[kBufferSize];
+	}
+
+	~Serializer() {
+		flush();
+		delete[] _buffer;
+	}
+
+	/** Hand all buffered data over to the save stream. */
+	void flush();
+
+	/** Pass chunk boundaries on to the given writer, which is the save stream. */
+	void setChunkWriter(SaveChunkWriter *writer) { _chunkWriter = writer; }
+
+	/**
+	 * Start a new chunk of the savegame, see SaveChunkWriter. Ids must be
+	 * unique within a savegame to be of any use, but don't affect the
+	 * data written. Does nothing when loading.
+	 */
+	void startChunk(uint32 id);
 
 	void saveLoadArrayOf(void *b, int len, int datasize, byte filetype);
 	void saveLoadArrayOf(void *b, int num, int datasize, const SaveLoadEntry *sle);
@@ -147,10 +266,25 @@ public:
 	void loadBytes(void *b, int len);
 
 protected:
-	Common::SeekableReadStream *_loadStream;
+	Common::ReadStream *_loadStream;
 	Common::WriteStream *_saveStream;
+	SaveChunkWriter *_chunkWriter;
 	uint32 _savegameVersion;
 
+	/**
+	 * Savefiles are usually compressing streams, for which every single
+	 * write or read call is expensive. Therefore the data is passed to and
+	 * from them in large blocks through this buffer. When loading, data
+	 * may be read ahead past the end of the savegame. It is allocated on
+	 * the heap, since serializers live on the stack.
+	 */
+	enum { kBufferSize = 16384 };
+	byte *_buffer;
+	uint32 _bufferPos;
+	uint32 _bufferSize;
+
+	void fillBuffer();
+
 	void saveArrayOf(void *b, int len, int datasize, byte filetype);
 	void loadArrayOf(void *b, int len, int datasize, byte filetype);
 
@@ -489,6 +489,9 @@ void ScummEngine::executeScript() {
 }
 
 void ScummEngine::executeOpcode(byte i) {
+	if (_profileOpcodes)
+		_opcodeCounts[i]++;
+
 	if (_opcodes[i].proc && _opcodes[i].proc->isValid())
 		(*_opcodes[i].proc)();
 	else {
@@ -35,6 +35,7 @@
 #include "graphics/cursorman.h"
 
 #include "scumm/akos.h"
+#include "scumm/boxes.h"
 #include "scumm/charset.h"
 #include "scumm/costume.h"
 #include "scumm/debugger.h"
@@ -66,6 +67,7 @@
 #include "scumm/player_v5m.h"
 #include "scumm/resource.h"
 #include "scumm/he/resource_he.h"
+#include "scumm/saveload.h"
 #include "scumm/scumm_v0.h"
 #include "scumm/scumm_v8.h"
 #include "scumm/sound.h"
@@ -224,6 +226,8 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 	_scriptPointer = NULL;
 	_scriptOrgPointer = NULL;
 	_opcode = 0;
+	_profileOpcodes = false;
+	memset(_opcodeCounts, 0, sizeof(_opcodeCounts));
 	vm.numNestedScripts = 0;
 	_lastCodePtr = NULL;
 	_scummStackPos = 0;
@@ -321,6 +325,9 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 	_keepText = false;
 	_costumeLoader = NULL;
 	_costumeRenderer = NULL;
+	_costumeFrameCache = NULL;
+	_boxGraph = new BoxGraph();
+	_saveChunkCache = new SaveChunkCache();
 	_2byteFontPtr = 0;
 	_V1TalkingActor = 0;
 	_NESStartStrip = 0;
@@ -611,6 +618,10 @@ ScummEngine::~ScummEngine() {
 
 	delete _costumeLoader;
 	delete _costumeRenderer;
+	delete _costumeFrameCache;
+	_costumeFrameCache = NULL;
+	delete _boxGraph;
+	delete _saveChunkCache;
 
 	_textSurface.free();
 
@@ -1400,6 +1411,14 @@ void ScummEngine::setupCostumeRenderer() {
 		_costumeRenderer = new ClassicCostumeRenderer(this);
 		_costumeLoader = new ClassicCostumeLoader(this);
 	}
+
+	// The budget of the decoded costume frame cache can be overridden
+	// (in KB) through the "costume_cache_size" config key; 0 disables it.
+	uint32 cacheSize = CostumeFrameCache::kDefaultMemoryBudget;
+	if (ConfMan.hasKey("costume_cache_size"))
+		cacheSize = MAX(ConfMan.getInt("costume_cache_size"), 0) * 1024;
+	if (cacheSize)
+		_costumeFrameCache = new CostumeFrameCache(cacheSize);
 }
 
 void ScummEngine::resetScumm() {
@@ -80,6 +80,7 @@ namespace Scumm {
 class Actor;
 class BaseCostumeLoader;
 class BaseCostumeRenderer;
+class CostumeFrameCache;
 class BaseScummFile;
 class CharsetRenderer;
 class IMuse;
@@ -88,9 +89,11 @@ class MusicEngine;
 class Player_Towns;
 class ScummEngine;
 class ScummDebugger;
+class SaveChunkCache;
 class Serializer;
 class Sound;
 
+class BoxGraph;
 struct Box;
 struct BoxCoords;
 struct FindObjectInRoom;
@@ -541,6 +544,7 @@ public:
 
 	BaseCostumeLoader *_costumeLoader;
 	BaseCostumeRenderer *_costumeRenderer;
+	CostumeFrameCache *_costumeFrameCache;
 
 	int _NESCostumeSet;
 	void NES_loadCostumeSet(int n);
@@ -594,6 +598,7 @@ protected:
 	bool _saveTemporaryState;
 	Common::String _saveLoadFileName;
 	Common::String _saveLoadDescription;
+	SaveChunkCache *_saveChunkCache;
 
 	bool saveState(Common::OutSaveFile *out, bool writeHeader = true);
 	bool saveState(int slot, bool compat);
@@ -644,6 +649,10 @@ protected:
 
 	OpcodeEntry _opcodes[256];
 
+	// Opcode profiling, controlled from the debugger
+	bool _profileOpcodes;
+	uint32 _opcodeCounts[256];
+
 	virtual void setupOpcodes() = 0;
 	void executeOpcode(byte i);
 	const char *getOpcodeDesc(byte i);
@@ -757,6 +766,7 @@ protected:
 	int readSoundResource(ResId idx);
 	int readSoundResourceSmallHeader(ResId idx);
 	bool isResourceInUse(ResType type, ResId idx) const;
+	virtual void resourceNuked(ResType type, ResId idx);
 
 	virtual void setupRoomSubBlocks();
 	virtual void resetRoomSubBlocks();
@@ -1155,7 +1165,8 @@ protected:
 	void setBoxScaleSlot(int box, int slot);
 	void convertScaleTableToScaleSlot(int slot);
 
-	void calcItineraryMatrix(byte *itineraryMatrix, int num);
+	BoxGraph *_boxGraph;
+	void updateBoxGraph();
 	void createBoxMatrix();
 	virtual bool areBoxesNeighbors(int i, int j);
 
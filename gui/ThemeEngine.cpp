@@ -1580,12 +1580,10 @@ bool ThemeEngine::themeConfigUsable(const Common::FSNode &node, Common::String &
 			// Open THEMERC from the ZIP file.
 			stream.open("THEMERC", *zipArchive);
 		}
-		// Delete the ZIP archive again. Note: This only works because
-		// stream.open() only uses ZipArchive::createReadStreamForMember,
-		// and that in turn happens to read all the data for a given
-		// archive member into a memory block. So there will be no dangling
-		// reference to zipArchive anywhere. This could change if we
-		// ever modify ZipArchive::createReadStreamForMember.
+		// Delete the ZIP archive again. Streams created by
+		// ZipArchive::createReadStreamForMember keep the data of the
+		// archive alive on their own, so there is no dangling reference
+		// to zipArchive anywhere.
 		delete zipArchive;
 	} else if (node.isDirectory()) {
 		Common::FSNode headerfile = node.getChild("THEMERC");
@@ -104,7 +104,27 @@ int SaveLoadChooserDialog::run(const Common::String &target, const MetaEngine *m
 	_saveDateSupport = _metaInfoSupport && _metaEngine->hasFeature(MetaEngine::kSavesSupportCreationDate);
 	_playTimeSupport = _metaInfoSupport && _metaEngine->hasFeature(MetaEngine::kSavesSupportPlayTime);
 
-	return runIntern();
+	// Savegames may have changed since the dialog was shown last time, so
+	// meta infos are only cached while it is running.
+	_metaInfoCache.clear();
+	const int result = runIntern();
+	_metaInfoCache.clear();
+
+	return result;
+}
+
+SaveStateDescriptor SaveLoadChooserDialog::querySaveMetaInfos(int slot) {
+	MetaInfoCache::const_iterator cached = _metaInfoCache.find(slot);
+	if (cached != _metaInfoCache.end())
+		return cached->_value;
+
+	SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), slot);
+	_metaInfoCache[slot] = desc;
+	return desc;
+}
+
+void SaveLoadChooserDialog::invalidateSaveMetaInfos(int slot) {
+	_metaInfoCache.erase(slot);
 }
 
 void SaveLoadChooserDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data) {
@@ -275,6 +295,7 @@ void SaveLoadChooserSimple::handleCommand(CommandSender *sender, uint32 cmd, uin
 								_("Delete"), _("Cancel"));
 			if (alert.runModal() == kMessageOK) {
 				_metaEngine->removeSaveState(_target.c_str(), _saveList[selItem].getSaveSlot());
+				invalidateSaveMetaInfos(_saveList[selItem].getSaveSlot());
 
 				setResult(-1);
 				_list->setSelected(-1);
@@ -360,7 +381,7 @@ void SaveLoadChooserSimple::updateSelection(bool redraw) {
 	_playtime->setLabel(_("No playtime saved"));
 
 	if (selItem >= 0 && _metaInfoSupport) {
-		SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), _saveList[selItem].getSaveSlot());
+		SaveStateDescriptor desc = querySaveMetaInfos(_saveList[selItem].getSaveSlot());
 
 		isDeletable = desc.getDeletableFlag() && _delSupport;
 		isWriteProtected = desc.getWriteProtectedFlag();
@@ -851,7 +872,7 @@ void SaveLoadChooserGrid::updateSaves() {
 	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
 		const uint saveSlot = _saveList[i].getSaveSlot();
 
-		SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot);
+		SaveStateDescriptor desc = querySaveMetaInfos(saveSlot);
 		SlotButton &curButton = _buttons[curNum];
 		curButton.setVisible(true);
 		const Graphics::Surface *thumbnail = desc.getThumbnail();
@@ -27,6 +27,8 @@
 
 #include "engines/metaengine.h"
 
+#include "common/hashmap.h"
+
 namespace GUI {
 
 #define kSwitchSaveLoadDialog -2
@@ -69,6 +71,19 @@ public:
 protected:
 	virtual int runIntern() = 0;
 
+	/**
+	 * Query the meta infos of a save slot. The results are kept until the
+	 * dialog closes, so that revisiting a slot does not read and decode
+	 * the savegame again.
+	 */
+	SaveStateDescriptor querySaveMetaInfos(int slot);
+
+	/** Forget the meta infos of a slot, e.g. after deleting it. */
+	void invalidateSaveMetaInfos(int slot);
+
+	typedef Common::HashMap<int, SaveStateDescriptor> MetaInfoCache;
+	MetaInfoCache			_metaInfoCache;
+
 	const bool				_saveMode;
 	const MetaEngine		*_metaEngine;
 	bool					_delSupport;
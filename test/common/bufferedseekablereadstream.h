@@ -81,4 +81,49 @@ class BufferedSeekableReadStreamTestSuite : public CxxTest::TestSuite {
 
 		delete &ssrs;
 	}
+
+	void test_adaptive() {
+		const uint32 size = 3 * 1024 * 1024;
+		byte *contents = new byte[size];
+		for (uint32 i = 0; i < size; ++i)
+			contents[i] = (i * 7) ^ (i >> 11);
+		Common::MemoryReadStream ms(contents, size);
+
+		Common::SeekableReadStream &ssrs
+			= *Common::wrapAdaptiveBufferedSeekableReadStream(&ms, DisposeAfterUse::NO);
+		TS_ASSERT_DIFFERS(&ssrs, &ms);
+		TS_ASSERT_EQUALS(ssrs.size(), (int32)size);
+
+		// Sequential reads of varying sizes, through growing blocks
+		byte buffer[5000];
+		uint32 pos = 0;
+		for (uint32 n = 1; pos + n <= size; n = (n * 3) % 4999 + 1) {
+			TS_ASSERT_EQUALS(ssrs.read(buffer, n), n);
+			TS_ASSERT_EQUALS(memcmp(buffer, contents + pos, n), 0);
+			pos += n;
+		}
+		TS_ASSERT_EQUALS(ssrs.pos(), (int32)pos);
+
+		// Going back and forth between a few places
+		for (uint32 i = 0; i < 10; ++i) {
+			const uint32 offsets[] = { 100, 2000000, 1000000 + i * 1000, size - 10 };
+			for (int j = 0; j < 4; ++j) {
+				TS_ASSERT(ssrs.seek(offsets[j]));
+				TS_ASSERT_EQUALS(ssrs.read(buffer, 10), (uint32)10);
+				TS_ASSERT_EQUALS(memcmp(buffer, contents + offsets[j], 10), 0);
+			}
+		}
+
+		TS_ASSERT(!ssrs.eos());
+		TS_ASSERT_EQUALS(ssrs.read(buffer, 1), (uint32)0);
+		TS_ASSERT(ssrs.eos());
+		TS_ASSERT(ssrs.seek(-3, SEEK_END));
+		TS_ASSERT(!ssrs.eos());
+		TS_ASSERT_EQUALS(ssrs.read(buffer, 10), (uint32)3);
+		TS_ASSERT(ssrs.eos());
+		TS_ASSERT(!ssrs.seek(1, SEEK_END));
+
+		delete &ssrs;
+		delete[] contents;
+	}
 };
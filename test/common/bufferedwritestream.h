@@ -0,0 +1,81 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/bufferedstream.h"
+
+/**
+ * Records the writes it receives, and fails writes beyond a given size.
+ */
+class CountingWriteStream : public Common::MemoryWriteStreamDynamic {
+public:
+	CountingWriteStream(uint32 limit) : Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES),
+		_limit(limit), _writes(0), _finalized(false), _err(false) {}
+
+	uint32 write(const void *dataPtr, uint32 dataSize) {
+		_writes++;
+		if (size() + dataSize > _limit) {
+			_err = true;
+			return 0;
+		}
+		return Common::MemoryWriteStreamDynamic::write(dataPtr, dataSize);
+	}
+
+	bool err() const { return _err; }
+	void clearErr() { _err = false; }
+	void finalize() { _finalized = true; }
+
+	uint32 _limit;
+	int _writes;
+	bool _finalized;
+	bool _err;
+};
+
+class BufferedWriteStreamTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_coalescing() {
+		CountingWriteStream *parent = new CountingWriteStream(0xFFFFFFFF);
+		Common::WriteStream *stream = Common::wrapBufferedWriteStream(parent, 16);
+
+		for (int i = 0; i < 40; i++)
+			stream->writeByte(i);
+		TS_ASSERT_EQUALS(parent->_writes, 2);
+		TS_ASSERT_EQUALS(parent->size(), (uint32)32);
+
+		// Larger than the buffer: passed on directly after the buffered data
+		byte block[20];
+		memset(block, 0xAA, sizeof(block));
+		stream->write(block, sizeof(block));
+		TS_ASSERT_EQUALS(parent->_writes, 4);
+		TS_ASSERT_EQUALS(parent->size(), (uint32)60);
+
+		stream->writeByte(0x55);
+		stream->finalize();
+		TS_ASSERT(parent->_finalized);
+		TS_ASSERT(!stream->err());
+		TS_ASSERT_EQUALS(parent->size(), (uint32)61);
+		TS_ASSERT_EQUALS(parent->getData()[39], 39);
+		TS_ASSERT_EQUALS(parent->getData()[60], 0x55);
+
+		delete stream;
+	}
+
+	void test_error() {
+		CountingWriteStream *parent = new CountingWriteStream(20);
+		Common::WriteStream *stream = Common::wrapBufferedWriteStream(parent, 16);
+
+		byte data[12];
+		memset(data, 0, sizeof(data));
+		TS_ASSERT_EQUALS(stream->write(data, sizeof(data)), (uint32)12);
+		TS_ASSERT_EQUALS(stream->write(data, sizeof(data)), (uint32)12);
+		TS_ASSERT(!stream->err());
+
+		// The buffered data doesn't fit into the parent anymore
+		stream->finalize();
+		TS_ASSERT(stream->err());
+
+		stream->clearErr();
+		TS_ASSERT(!stream->err());
+
+		delete stream;
+	}
+};
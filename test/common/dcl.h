@@ -0,0 +1,168 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/dcl.h"
+#include "common/memstream.h"
+
+/**
+ * Writes a DCL bit stream, least significant bit first.
+ */
+class DCLBitWriter {
+public:
+	DCLBitWriter() : _bits(0), _nBits(0) {}
+
+	void putBits(uint32 value, int n) {
+		for (int i = 0; i < n; i++)
+			putBit((value >> i) & 1);
+	}
+
+	/** Write a Huffman code, given as the bits in the order they are read. */
+	void putCode(const char *code) {
+		for (; *code; code++)
+			putBit(*code == '1');
+	}
+
+	void putLiteral(byte value) {
+		putBit(0);
+		putBits(value, 8);
+	}
+
+	/** Copy three bytes from 'distance' (1-16) bytes back, for length_param 4. */
+	void putCopy3(int distance) {
+		putBit(1);
+		putCode("11");	// length 3
+		putCode("11");	// distance bits 0
+		putBits(distance - 1, 4);
+	}
+
+	/** Copy two bytes from 'distance' (1-4) bytes back. */
+	void putCopy2(int distance) {
+		putBit(1);
+		putCode("101");	// length 2
+		putCode("11");	// distance bits 0
+		putBits(distance - 1, 2);
+	}
+
+	const Common::Array<byte> &finish() {
+		if (_nBits)
+			_data.push_back(_bits);
+		_bits = 0;
+		_nBits = 0;
+		return _data;
+	}
+
+private:
+	void putBit(int bit) {
+		_bits |= bit << _nBits;
+		if (++_nBits == 8) {
+			_data.push_back(_bits);
+			_bits = 0;
+			_nBits = 0;
+		}
+	}
+
+	Common::Array<byte> _data;
+	byte _bits;
+	int _nBits;
+};
+
+class DCLTestSuite : public CxxTest::TestSuite {
+	bool unpack(const Common::Array<byte> &packed, byte *dest, uint32 unpackedSize) {
+		Common::MemoryReadStream stream(packed.begin(), packed.size());
+		return Common::decompressDCL(&stream, dest, packed.size(), unpackedSize);
+	}
+
+	public:
+	void test_binary_literals() {
+		DCLBitWriter w;
+		w.putBits(0, 8);	// binary mode
+		w.putBits(4, 8);	// length_param
+		w.putLiteral('D');
+		w.putLiteral('C');
+		w.putLiteral('L');
+
+		byte out[3];
+		TS_ASSERT(unpack(w.finish(), out, 3));
+		TS_ASSERT_EQUALS(out[0], 'D');
+		TS_ASSERT_EQUALS(out[1], 'C');
+		TS_ASSERT_EQUALS(out[2], 'L');
+	}
+
+	void test_copies() {
+		DCLBitWriter w;
+		w.putBits(0, 8);
+		w.putBits(4, 8);
+		w.putLiteral('a');
+		w.putLiteral('b');
+		w.putCopy3(2);	// overlapping copy: "aba"
+		w.putCopy2(4);	// "ba"
+
+		byte out[7];
+		TS_ASSERT(unpack(w.finish(), out, 7));
+		TS_ASSERT_EQUALS(memcmp(out, "abababa", 7), 0);
+	}
+
+	void test_ascii_mode() {
+		DCLBitWriter w;
+		w.putBits(1, 8);	// ASCII mode
+		w.putBits(4, 8);
+		w.putCode("0");
+		w.putCode("1111");			// ' ', 4 bit code
+		w.putCode("0");
+		w.putCode("11011");			// 'e', 5 bit code
+		w.putCode("0");
+		w.putCode("0000100101");	// 'z', longer than the lookup tables
+		w.putCode("0");
+		w.putCode("00001111");		// 'x', exactly as long as the lookup tables
+
+		byte out[4];
+		TS_ASSERT(unpack(w.finish(), out, 4));
+		TS_ASSERT_EQUALS(memcmp(out, " ezx", 4), 0);
+	}
+
+	void test_bad_distance() {
+		DCLBitWriter w;
+		w.putBits(0, 8);
+		w.putBits(4, 8);
+		w.putLiteral('a');
+		w.putCopy3(2);	// nothing to copy from yet
+
+		byte out[4];
+		TS_ASSERT(!unpack(w.finish(), out, 4));
+	}
+
+	/**
+	 * Decompresses a payload much larger than the decompressor's input
+	 * buffer, mixing literals and copies.
+	 */
+	void test_large_payload() {
+		const int kBlocks = 20000;
+		DCLBitWriter w;
+		Common::Array<byte> expected;
+
+		w.putBits(0, 8);
+		w.putBits(4, 8);
+		for (int i = 0; i < 16; i++) {
+			w.putLiteral(i * 7);
+			expected.push_back(i * 7);
+		}
+		for (int i = 0; i < kBlocks; i++) {
+			const byte literal = (i * 13) & 0xFF;
+			w.putLiteral(literal);
+			expected.push_back(literal);
+
+			const int distance = 1 + (i % 16);
+			for (int j = 0; j < 3; j++)
+				expected.push_back(expected[expected.size() - distance]);
+			w.putCopy3(distance);
+		}
+
+		const Common::Array<byte> &packed = w.finish();
+		TS_ASSERT_LESS_THAN((uint)4096, packed.size());
+
+		byte *out = new byte[expected.size()];
+		TS_ASSERT(unpack(packed, out, expected.size()));
+		TS_ASSERT_EQUALS(memcmp(out, expected.begin(), expected.size()), 0);
+		delete[] out;
+	}
+};
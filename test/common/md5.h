@@ -1,7 +1,8 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/md5.h"
-#include "common/stream.h"
+#include "common/memstream.h"
+#include "common/util.h"
 
 /*
  * those are the standard RFC 1321 test vectors
@@ -47,4 +48,83 @@ class MD5TestSuite : public CxxTest::TestSuite {
 		}
 	}
 
+	void test_incremental() {
+		for (int i = 0; i < 7; i++) {
+			const char *str = md5_test_string[i];
+			const uint32 len = strlen(str);
+
+			// Feed the data in pieces of growing size
+			Common::MD5 md5;
+			uint32 pos = 0;
+			for (uint32 piece = 1; pos < len; piece++) {
+				const uint32 size = MIN(piece, len - pos);
+				md5.update(str + pos, size);
+				pos += size;
+			}
+			TS_ASSERT_EQUALS(md5.finishAsString(), md5_test_digest[i]);
+
+			md5.reset();
+			md5.update(str, len);
+			TS_ASSERT_EQUALS(md5.finishAsString(), md5_test_digest[i]);
+		}
+	}
+
+	void test_computeStreamsMD5() {
+		Common::ReadStream *streams[7];
+		for (int i = 0; i < 7; i++)
+			streams[i] = new Common::MemoryReadStream((const byte *)md5_test_string[i], strlen(md5_test_string[i]));
+
+		uint8 digests[7][16];
+		TS_ASSERT(Common::computeStreamsMD5(streams, 7, digests));
+
+		for (int i = 0; i < 7; i++) {
+			Common::MemoryReadStream stream((const byte *)md5_test_string[i], strlen(md5_test_string[i]));
+			uint8 digest[16];
+			Common::computeStreamMD5(stream, digest);
+			TS_ASSERT_EQUALS(memcmp(digest, digests[i], 16), 0);
+			delete streams[i];
+		}
+	}
+
+	/**
+	 * Hashes a million bytes through the single and the interleaved code
+	 * paths, with and without a length restriction.
+	 */
+	void test_large_input() {
+		const uint32 size = 1000000;
+		byte *data = new byte[size];
+		memset(data, 'a', size);
+
+		Common::MemoryReadStream stream(data, size);
+		TS_ASSERT_EQUALS(Common::computeStreamMD5AsString(stream), "7707d6ae4e027c70eea2a935c2296f21");
+
+		Common::MemoryReadStream first(data, size);
+		Common::MemoryReadStream second(data, size);
+		Common::ReadStream *streams[2] = { &first, &second };
+		uint8 digests[2][16];
+		TS_ASSERT(Common::computeStreamsMD5(streams, 2, digests));
+		TS_ASSERT_EQUALS(memcmp(digests[0], digests[1], 16), 0);
+
+		Common::MD5 md5;
+		md5.update(data, size);
+		uint8 digest[16];
+		md5.finish(digest);
+		TS_ASSERT_EQUALS(memcmp(digest, digests[0], 16), 0);
+
+		// Streams of different lengths, hashed in several chunks
+		Common::MemoryReadStream longer(data, size);
+		Common::MemoryReadStream shorter(data, 100000);
+		streams[0] = &longer;
+		streams[1] = &shorter;
+		TS_ASSERT(Common::computeStreamsMD5(streams, 2, digests, 200000));
+		longer.seek(0);
+		shorter.seek(0);
+		Common::computeStreamMD5(longer, digest, 200000);
+		TS_ASSERT_EQUALS(memcmp(digest, digests[0], 16), 0);
+		Common::computeStreamMD5(shorter, digest, 200000);
+		TS_ASSERT_EQUALS(memcmp(digest, digests[1], 16), 0);
+
+		delete[] data;
+	}
+
 };
@@ -100,4 +100,16 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_peek_pointer() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		ms.seek(2);
+		TS_ASSERT_EQUALS(ms.peekPointer(5), contents + 2);
+		TS_ASSERT_EQUALS(ms.pos(), 2);
+		TS_ASSERT(!ms.peekPointer(6));
+		ms.seek(0, SEEK_END);
+		TS_ASSERT_EQUALS(ms.peekPointer(0), contents + 7);
+	}
 };
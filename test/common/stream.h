@@ -1,6 +1,8 @@
 #include <cxxtest/TestSuite.h>
 
+#include "common/bufferedstream.h"
 #include "common/memstream.h"
+#include "common/substream.h"
 
 class ReadLineStreamTestSuite : public CxxTest::TestSuite {
 	public:
@@ -44,3 +46,48 @@ class ReadLineStreamTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT(ms.eos());
 	}
 };
+
+class StreamSpanTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_borrowed_span() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::SeekableSubReadStream sub(&ms, 2, 6);
+		Common::StreamSpan span;
+
+		TS_ASSERT(sub.peekSpan(3, span));
+		TS_ASSERT(span.isBorrowed());
+		TS_ASSERT_EQUALS(span.data(), contents + 2);
+		TS_ASSERT_EQUALS(sub.pos(), 0);
+
+		sub.seek(1);
+		TS_ASSERT(sub.readSpan(3, span));
+		TS_ASSERT_EQUALS(span.data(), contents + 3);
+		TS_ASSERT_EQUALS(span.size(), (uint32)3);
+		TS_ASSERT_EQUALS(sub.pos(), 4);
+
+		// Beyond the end of the substream
+		sub.seek(2);
+		TS_ASSERT(!sub.readSpan(3, span));
+		TS_ASSERT(!span.data());
+	}
+
+	void test_copied_span() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::SeekableReadStream *stream = Common::wrapBufferedSeekableReadStream(
+			new Common::MemoryReadStream(contents, sizeof(contents)), 4, DisposeAfterUse::YES);
+		Common::StreamSpan span;
+
+		stream->seek(1);
+		TS_ASSERT(stream->peekSpan(5, span));
+		TS_ASSERT(!span.isBorrowed());
+		TS_ASSERT_EQUALS(memcmp(span.data(), contents + 1, 5), 0);
+		TS_ASSERT_EQUALS(stream->pos(), 1);
+
+		TS_ASSERT(stream->readSpan(6, span));
+		TS_ASSERT_EQUALS(memcmp(span.data(), contents + 1, 6), 0);
+		TS_ASSERT_EQUALS(stream->pos(), 7);
+
+		delete stream;
+	}
+};
@@ -0,0 +1,48 @@
+#ifndef TEST_COMMON_STREAMHELPERS_H
+#define TEST_COMMON_STREAMHELPERS_H
+
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/stream.h"
+#include "common/zlib.h"
+
+/*
+ * Helpers shared by the stream and archive test suites. This file has no
+ * test suite of its own.
+ */
+namespace StreamTest {
+
+/** Compressible, but not trivially, so that deflate emits many blocks. */
+inline Common::Array<byte> makeData(uint32 size, uint32 seed) {
+	Common::Array<byte> data;
+	data.reserve(size);
+	for (uint32 i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		data.push_back((seed >> 16) & 0x1F);
+	}
+	return data;
+}
+
+/** Compress data with the gzip writer. */
+inline Common::Array<byte> gzipData(const Common::Array<byte> &data) {
+	Common::MemoryWriteStreamDynamic *memory = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+	Common::WriteStream *gzip = Common::wrapCompressedWriteStream(memory);
+	gzip->write(data.begin(), data.size());
+	gzip->finalize();
+	Common::Array<byte> result(memory->getData(), memory->size());
+	delete gzip;
+	return result;
+}
+
+/** Check that the given range of the stream holds the same bytes as data. */
+inline bool readMatches(Common::SeekableReadStream *stream, const Common::Array<byte> &data, uint32 offset, uint32 length) {
+	byte *buffer = new byte[length];
+	const bool result = stream->seek(offset) && stream->read(buffer, length) == length
+		&& !memcmp(buffer, &data[offset], length);
+	delete[] buffer;
+	return result;
+}
+
+} // End of namespace StreamTest
+
+#endif
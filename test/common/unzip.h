@@ -0,0 +1,182 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+#include "streamhelpers.h"
+
+/**
+ * Builds a zip archive in memory. Deflated members are compressed with the
+ * gzip writer, whose header and trailer are stripped again.
+ */
+class ZipBuilder {
+public:
+	void addMember(const char *name, const Common::Array<byte> &data, bool deflate) {
+		Common::Array<byte> gzip = StreamTest::gzipData(data);
+		const uint32 crc = READ_LE_UINT32(&gzip[gzip.size() - 8]);
+
+		Common::Array<byte> packed;
+		if (deflate)
+			packed = Common::Array<byte>(&gzip[10], gzip.size() - 18);
+		else
+			packed = data;
+
+		Entry entry;
+		entry.name = name;
+		entry.method = deflate ? 8 : 0;
+		entry.crc = crc;
+		entry.compressedSize = packed.size();
+		entry.size = data.size();
+		entry.offset = _zip.size();
+		_entries.push_back(entry);
+
+		putUint32(0x04034b50);
+		putHeader(entry);
+		putUint16(0);	// extra field length
+		putString(entry.name);
+		_zip.push_back(packed);
+	}
+
+	Common::SeekableReadStream *finish() {
+		const uint32 centralStart = _zip.size();
+		for (uint i = 0; i < _entries.size(); i++) {
+			putUint32(0x02014b50);
+			putUint16(20);	// version made by
+			putHeader(_entries[i]);
+			putUint16(0);	// extra field length
+			putUint16(0);	// comment length
+			putUint16(0);	// disk number
+			putUint16(0);	// internal attributes
+			putUint32(0);	// external attributes
+			putUint32(_entries[i].offset);
+			putString(_entries[i].name);
+		}
+		const uint32 centralSize = _zip.size() - centralStart;
+
+		putUint32(0x06054b50);
+		putUint16(0);
+		putUint16(0);
+		putUint16(_entries.size());
+		putUint16(_entries.size());
+		putUint32(centralSize);
+		putUint32(centralStart);
+		putUint16(0);	// comment length
+
+		byte *data = (byte *)malloc(_zip.size());
+		memcpy(data, _zip.begin(), _zip.size());
+		return new Common::MemoryReadStream(data, _zip.size(), DisposeAfterUse::YES);
+	}
+
+private:
+	struct Entry {
+		Common::String name;
+		uint16 method;
+		uint32 crc;
+		uint32 compressedSize;
+		uint32 size;
+		uint32 offset;
+	};
+
+	void putHeader(const Entry &entry) {
+		putUint16(20);	// version needed
+		putUint16(0);	// flags
+		putUint16(entry.method);
+		putUint32(0);	// time and date
+		putUint32(entry.crc);
+		putUint32(entry.compressedSize);
+		putUint32(entry.size);
+		putUint16(entry.name.size());
+	}
+
+	void putUint16(uint16 value) {
+		_zip.push_back(value & 0xFF);
+		_zip.push_back(value >> 8);
+	}
+
+	void putUint32(uint32 value) {
+		putUint16(value & 0xFFFF);
+		putUint16(value >> 16);
+	}
+
+	void putString(const Common::String &str) {
+		for (uint i = 0; i < str.size(); i++)
+			_zip.push_back(str[i]);
+	}
+
+	Common::Array<byte> _zip;
+	Common::Array<Entry> _entries;
+};
+
+class UnzipTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_stored_member() {
+		const Common::Array<byte> data = StreamTest::makeData(5000, 1);
+		ZipBuilder builder;
+		builder.addMember("stored.bin", data, false);
+		Common::Archive *archive = Common::makeZipArchive(builder.finish());
+		TS_ASSERT(archive);
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("STORED.BIN");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), 5000);
+		TS_ASSERT(StreamTest::readMatches(stream, data, 4000, 1000));
+		TS_ASSERT(StreamTest::readMatches(stream, data, 0, 100));
+
+		// The member stream outlives the archive
+		delete archive;
+		TS_ASSERT(StreamTest::readMatches(stream, data, 100, 4900));
+		delete stream;
+	}
+
+#ifdef USE_ZLIB
+	void test_deflated_members() {
+		const Common::Array<byte> small = StreamTest::makeData(70000, 2);
+		const Common::Array<byte> large = StreamTest::makeData(3 * 1024 * 1024, 3);
+		ZipBuilder builder;
+		builder.addMember("small.bin", small, true);
+		builder.addMember("stored.bin", small, false);
+		builder.addMember("large.bin", large, true);
+		Common::Archive *archive = Common::makeZipArchive(builder.finish());
+		TS_ASSERT(archive);
+
+		// Several members read at the same time
+		Common::SeekableReadStream *smallStream = archive->createReadStreamForMember("small.bin");
+		Common::SeekableReadStream *storedStream = archive->createReadStreamForMember("stored.bin");
+		Common::SeekableReadStream *largeStream = archive->createReadStreamForMember("large.bin");
+		TS_ASSERT(smallStream && storedStream && largeStream);
+		TS_ASSERT_EQUALS(largeStream->size(), 3 * 1024 * 1024);
+
+		TS_ASSERT(StreamTest::readMatches(smallStream, small, 0, 1000));
+		TS_ASSERT(StreamTest::readMatches(largeStream, large, 0, 1000));
+		TS_ASSERT(StreamTest::readMatches(storedStream, small, 1000, 1000));
+		TS_ASSERT(StreamTest::readMatches(smallStream, small, 1000, 69000));
+		TS_ASSERT(!smallStream->err());
+
+		// Within the window, far backwards, and forwards past restart points
+		TS_ASSERT(StreamTest::readMatches(smallStream, small, 60000, 100));
+		TS_ASSERT(StreamTest::readMatches(smallStream, small, 10, 100));
+		TS_ASSERT(StreamTest::readMatches(largeStream, large, 3 * 1024 * 1024 - 100, 100));
+		TS_ASSERT(StreamTest::readMatches(largeStream, large, 1500000, 50000));
+		TS_ASSERT(StreamTest::readMatches(largeStream, large, 700000, 1000));
+		TS_ASSERT(StreamTest::readMatches(largeStream, large, 2900000, 1000));
+		TS_ASSERT(StreamTest::readMatches(largeStream, large, 5, 10));
+		TS_ASSERT(!largeStream->err());
+
+		byte b;
+		TS_ASSERT(largeStream->seek(0, SEEK_END));
+		TS_ASSERT(!largeStream->eos());
+		TS_ASSERT_EQUALS(largeStream->read(&b, 1), (uint32)0);
+		TS_ASSERT(largeStream->eos());
+
+		delete archive;
+		TS_ASSERT(StreamTest::readMatches(smallStream, small, 30000, 40000));
+		delete smallStream;
+		delete storedStream;
+		delete largeStream;
+	}
+#endif
+};
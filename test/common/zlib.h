@@ -0,0 +1,82 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/zlib.h"
+
+#include "streamhelpers.h"
+
+/**
+ * Forwards to another stream, but hides its data from peekPointer(), like
+ * a file on disk would.
+ */
+class OpaqueReadStream : public Common::SeekableReadStream {
+public:
+	OpaqueReadStream(Common::SeekableReadStream *parent) : _parent(parent) {}
+	~OpaqueReadStream() { delete _parent; }
+
+	bool eos() const { return _parent->eos(); }
+	bool err() const { return _parent->err(); }
+	void clearErr() { _parent->clearErr(); }
+	uint32 read(void *dataPtr, uint32 dataSize) { return _parent->read(dataPtr, dataSize); }
+	int32 pos() const { return _parent->pos(); }
+	int32 size() const { return _parent->size(); }
+	bool seek(int32 offset, int whence = SEEK_SET) { return _parent->seek(offset, whence); }
+
+private:
+	Common::SeekableReadStream *_parent;
+};
+
+class ZlibTestSuite : public CxxTest::TestSuite {
+	static Common::SeekableReadStream *compress(const Common::Array<byte> &data) {
+		const Common::Array<byte> gzip = StreamTest::gzipData(data);
+		byte *packed = (byte *)malloc(gzip.size());
+		memcpy(packed, gzip.begin(), gzip.size());
+		return new Common::MemoryReadStream(packed, gzip.size(), DisposeAfterUse::YES);
+	}
+
+	void checkRoundTrip(uint32 size, bool opaque) {
+		const Common::Array<byte> data = StreamTest::makeData(size, size);
+		Common::SeekableReadStream *packed = compress(data);
+		TS_ASSERT_LESS_THAN(packed->size(), (int32)size);
+		if (opaque)
+			packed = new OpaqueReadStream(packed);
+
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(packed);
+		TS_ASSERT_EQUALS(stream->size(), (int32)size);
+		TS_ASSERT(StreamTest::readMatches(stream, data, 0, size));
+		TS_ASSERT(!stream->err());
+
+		byte b;
+		TS_ASSERT_EQUALS(stream->read(&b, 1), (uint32)0);
+		TS_ASSERT(stream->eos());
+
+		// Backwards and forwards again
+		TS_ASSERT(StreamTest::readMatches(stream, data, 10, 1000));
+		TS_ASSERT(StreamTest::readMatches(stream, data, size - 5000, 5000));
+		TS_ASSERT(!stream->err());
+
+		delete stream;
+	}
+
+	public:
+#ifdef USE_ZLIB
+	void test_memory_source() {
+		checkRoundTrip(1024 * 1024, false);
+		checkRoundTrip(4 * 1024 * 1024, false);
+	}
+
+	void test_opaque_source() {
+		checkRoundTrip(1024 * 1024, true);
+		checkRoundTrip(4 * 1024 * 1024, true);
+	}
+#endif
+
+	void test_uncompressed_passthrough() {
+		static const byte data[] = "Not compressed";
+		Common::SeekableReadStream *plain = new Common::MemoryReadStream(data, sizeof(data));
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(plain);
+		TS_ASSERT_EQUALS(stream, plain);
+		delete stream;
+	}
+};
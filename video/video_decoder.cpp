@@ -25,6 +25,7 @@
 #include "audio/audiostream.h"
 #include "audio/mixer.h" // for kMaxChannelVolume
 
+#include "common/bufferedstream.h"
 #include "common/rational.h"
 #include "common/file.h"
 #include "common/system.h"
@@ -83,7 +84,7 @@ bool VideoDecoder::loadFile(const Common::String &filename) {
 		return false;
 	}
 
-	return loadStream(file);
+	return loadStream(Common::wrapAdaptiveBufferedSeekableReadStream(file, DisposeAfterUse::YES));
 }
 
 bool VideoDecoder::needsUpdate() const {